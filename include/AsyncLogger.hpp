@@ -4,15 +4,23 @@
 #define __ASYNC_LOGGER_H__
 
 #include "Logger.hpp"
+#include "AsyncOptions.hpp"
+#include "LogExecutor.hpp"
 
-#include <queue>
-#include <thread>
+#include <algorithm>
+#include <array>
 #include <condition_variable>
 #include <atomic>
 
 namespace log
 {
     // 异步日志记录器类，继承自 Logger
+    // 日志消息在生产者线程入队，由 LogExecutor 的工作线程格式化并写入接收器。
+    // 不指定执行器时，日志器创建一个私有执行器，线程数为 options.format_threads（至少一个）。
+    // 执行器的 format_threads 大于1时，多个工作线程可以同时格式化本日志器的日志，按取出的顺序重排后写入。
+    // 开启 priority_lanes 时每个级别有自己的队列，积压时先处理高级别日志，同一级别内保持顺序；
+    // 队列长度达到 shed_*_watermark 时丢弃对应级别的新日志，积压消除后输出一条汇总各级别丢弃数量的日志。
+    // 使用共享执行器时，这些配置取自执行器的 AsyncOptions。
     class AsyncLogger : public Logger{
         public:
             using ptr = std::shared_ptr<AsyncLogger>;
@@ -20,52 +28,180 @@ namespace log
                 const std::string& name = "root",
                 LogLevel::Level level = LogLevel::Level::UNKNOWN,
                 Formatter::ptr formatter = nullptr,
-                std::vector<LogSink::ptr> sinks = {}
-                ): Logger(name, level, formatter, sinks), _running(true){
-                _thread = std::thread(&AsyncLogger::consumeLogTask, this); // 启动工作线程
+                std::vector<LogSink::ptr> sinks = {},
+                AsyncOptions options = {}
+                ): AsyncLogger(name, level, formatter, sinks, std::make_shared<LogExecutor>(std::max<size_t>(options.format_threads, 1), options)){}
+
+            // 使用共享的执行器
+            AsyncLogger(
+                const std::string& name,
+                LogLevel::Level level,
+                Formatter::ptr formatter,
+                std::vector<LogSink::ptr> sinks,
+                LogExecutor::ptr executor
+                ): Logger(name, level, formatter, sinks), _executor(std::move(executor)),
+                   _max_inflight(std::max<size_t>(_executor->GetOptions().format_threads, 1)),
+                   _priority_lanes(_executor->GetOptions().priority_lanes){
+                const AsyncOptions& options = _executor->GetOptions();
+                _shed_watermark[LogLevel::Level::UNKNOWN] = options.shed_debug_watermark;
+                _shed_watermark[LogLevel::Level::DEBUG] = options.shed_debug_watermark;
+                _shed_watermark[LogLevel::Level::INFO] = options.shed_info_watermark;
+                _shed_watermark[LogLevel::Level::WARN] = options.shed_warn_watermark;
+                for (size_t watermark : _shed_watermark) {
+                    if (watermark > 0 && (_resume_depth == 0 || watermark < _resume_depth)) {
+                        _resume_depth = watermark; // 最低的水位
+                    }
+                }
             }
+
             ~AsyncLogger() override{
-                _running = false;
-                _cond_var.notify_all();
-                if (_thread.joinable()) {
-                    _thread.join(); // 等待工作线程结束
-                }
+                Flush(); // 确保所有日志都被写入后再与执行器分离
+            }
+
+            // 等待已经提交的日志全部写入接收器
+            void Flush(){
+                std::unique_lock<std::mutex> lock(_queue_mutex);
+                _drained.wait(lock, [this]{ return idle(); });
             }
+
         protected:
-            void dispatchLog(const std::string& formatted_msg) override {
+            void dispatchLog(MsgBuffer::ptr buf) override {
+                size_t level = levelIndex(buf->msg.getLevel());
+                bool schedule = false;
                 {
-                    // 异步处理日志消息
+                    // 异步处理日志消息，格式化交给工作线程完成
                     std::unique_lock<std::mutex> lock(_queue_mutex);
-                    _log_queue.push(formatted_msg);
+                    if (_shed_watermark[level] > 0 && _depth >= _shed_watermark[level]) {
+                        _shed[level]++; // 积压过多，丢弃该级别的日志，缓冲区归还缓冲池
+                        return;
+                    }
+                    MsgBuffer* node = buf.release(); // 缓冲区本身作为队列节点，入队不分配内存
+                    Lane& lane = _lanes[_priority_lanes ? level : 0];
+                    if (lane.tail) {
+                        lane.tail->next = node;
+                    } else {
+                        lane.head = node;
+                    }
+                    lane.tail = node;
+                    _depth++;
+                    if (!_scheduled && _inflight < _max_inflight) {
+                        _scheduled = true; // 交给执行器调度
+                        schedule = true;
+                    }
+                }
+                if (schedule) {
+                    _executor->Schedule(this);
                 }
-                _cond_var.notify_one(); // 通知工作线程有新日志消息
             }
 
         private:
-            void consumeLogTask(){
-                while(_running){
+            friend class LogExecutor;
+
+            // 待处理队列，开启 priority_lanes 时每个级别一个，否则只使用第一个
+            struct Lane{
+                MsgBuffer* head = nullptr;
+                MsgBuffer* tail = nullptr;
+            };
+            static constexpr size_t kLevels = LogLevel::Level::OFF + 1;
+
+            // 取出最多limit条日志消息，由执行器在处理本日志器时调用，高级别的队列优先；
+            // ticket 为本批的序号，并行格式化时按序号写入；
+            // 还有日志且正在处理的批次未达上限时 reschedule 为true，调用者应立即重新调度本日志器
+            MsgBuffer* takeBatch(size_t limit, uint64_t& ticket, bool& reschedule){
+                MsgBuffer* head = nullptr;
+                MsgBuffer** tail = &head;
+                std::array<size_t, kLevels> shed{};
+                bool report = false;
+                {
                     std::unique_lock<std::mutex> lock(_queue_mutex);
-                    _cond_var.wait(lock, [this]{
-                        return !_log_queue.empty() || !_running; // 等待直到有日志消息或停止运行
-                    });
-                    if (!_running && _log_queue.empty()) {
-                        return;; // 如果停止运行且队列为空，退出循环
+                    size_t taken = 0;
+                    for (size_t i = _lanes.size(); i-- > 0 && taken < limit; ) {
+                        Lane& lane = _lanes[i];
+                        while (lane.head && taken < limit) {
+                            *tail = lane.head;
+                            tail = &lane.head->next;
+                            lane.head = lane.head->next;
+                            taken++;
+                        }
+                        if (!lane.head) {
+                            lane.tail = nullptr;
+                        }
                     }
-                    std::string msg = std::move(_log_queue.front());
-                    _log_queue.pop(); // 获取并移除队列中的日志消息
-                    lock.unlock(); // 解锁互斥锁，以允许其他线程访问队列
-                    for (auto& sink : _sinks){
-                        sink->LogtoSink(msg.c_str(), msg.length()); // 将日志消息发送到所有接收器
+                    *tail = nullptr;
+                    _depth -= taken;
+                    if (_depth < _resume_depth && std::any_of(_shed.begin(), _shed.end(), [](size_t n){ return n > 0; })) {
+                        shed.swap(_shed); // 积压已消除，汇报丢弃的数量
+                        report = LogLevel::Level::WARN >= _threshold.load(std::memory_order_relaxed); // 日志器不输出WARN时只清零计数
                     }
+                    ticket = _next_ticket++;
+                    _inflight++;
+                    reschedule = _depth > 0 && _inflight < _max_inflight;
+                    if (!reschedule) {
+                        _scheduled = false; // 由 finishBatch 或新日志重新调度
+                    }
+                }
+                if (report) {
+                    *tail = shedReport(shed).release(); // 汇总日志和本批日志一起格式化写入
+                }
+                return head;
+            }
+
+            // count批日志写入完毕，需要重新调度本日志器时返回true；全部写完时通知 Flush
+            bool finishBatch(size_t count = 1){
+                std::unique_lock<std::mutex> lock(_queue_mutex);
+                _inflight -= count;
+                if (_depth > 0 && !_scheduled && _inflight < _max_inflight) {
+                    _scheduled = true;
+                    return true;
+                }
+                if (idle()) {
+                    _drained.notify_all(); // 返回后执行器不再访问本日志器
                 }
+                return false;
+            }
+
+            // 没有排队和正在处理的日志，调用者需持有 _queue_mutex
+            bool idle() const {
+                return _depth == 0 && !_scheduled && _inflight == 0;
             }
 
-            std::queue<std::string> _log_queue;
+            static size_t levelIndex(LogLevel::Level level) {
+                return level < kLevels ? static_cast<size_t>(level) : kLevels - 1;
+            }
+
+            // 生成汇总丢弃数量的日志，在工作线程中调用；
+            // 它不属于任何生产者，不带线程信息和MDC，文件名为日志器名称、行号为0
+            MsgBuffer::ptr shedReport(const std::array<size_t, kLevels>& shed) {
+                MsgBuffer::ptr buf = MsgPool::Acquire();
+                buf->msg.reset(LogLevel::Level::WARN, _logger, _logger, 0);
+                buf->msg.setThreadInfo(nullptr);
+                buf->msg.setMDC(nullptr);
+                std::string& payload = buf->msg.getPayloadBuffer();
+                payload.append("log backlog shed");
+                for (size_t level = 0; level < kLevels; level++) {
+                    if (shed[level] > 0) {
+                        payload.append(" ").append(LogLevel::ToString(static_cast<LogLevel::Level>(level)));
+                        payload.append("=").append(std::to_string(shed[level]));
+                    }
+                }
+                return buf;
+            }
+
+            LogExecutor::ptr _executor; // 执行器
+            std::array<Lane, kLevels> _lanes; // 按级别分开的待处理队列，受 _queue_mutex 保护
+            size_t _depth = 0; // 待处理日志总数，受 _queue_mutex 保护
+            uint64_t _next_ticket = 0; // 下一批日志的序号，受 _queue_mutex 保护
+            bool _scheduled = false; // 是否在执行器的就绪队列中（或已被取出、尚未取走日志），受 _queue_mutex 保护
+            size_t _inflight = 0; // 已取出、尚未写入的批次数，受 _queue_mutex 保护
+            const size_t _max_inflight; // 同时处理的最大批次数，即执行器的 format_threads
+            LogExecutor::ReorderBuffer _reorder; // 并行格式化时的重排缓冲区
+            const bool _priority_lanes; // 是否按级别分道
+            std::array<size_t, kLevels> _shed_watermark{}; // 各级别开始丢弃的队列长度，0表示不丢弃
+            size_t _resume_depth = 0; // 队列长度低于此值时汇报丢弃数量，即最低的水位
+            std::array<size_t, kLevels> _shed{}; // 尚未汇报的丢弃数量，受 _queue_mutex 保护
+            AsyncLogger* _ready_next = nullptr; // 执行器就绪队列中的下一个日志器
             std::mutex _queue_mutex;
-            std::condition_variable _cond_var;
-            std::thread _thread;
-            std::atomic<bool> _running;
+            std::condition_variable _drained; // 日志全部写入后通知 Flush
     };
 }
 #endif
-
@@ -0,0 +1,95 @@
+#pragma once
+
+#ifndef __ASYNC_OPTIONS_H__
+#define __ASYNC_OPTIONS_H__
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <pthread.h>
+#include <sched.h>
+
+/*
+ * AsyncOptions用于配置异步日志后台线程的行为：
+ * 等待策略决定后台线程在队列为空时如何等待新日志，
+ *   BusySpin   一直自旋，延迟最低，独占一个CPU；
+ *   SpinYield  先自旋，之后不断让出CPU；
+ *   SpinPark   先自旋，之后在条件变量上休眠（默认），只有休眠时生产者才需要唤醒它；
+ *   TimedPoll  按固定间隔轮询，生产者从不唤醒后台线程。
+ * cpu 和 sched_policy/sched_priority 用于把后台线程绑定到指定CPU并设置调度优先级，
+ * 使日志线程远离延迟敏感的核心。
+ * batch_size 是工作线程每次轮到一个日志器时最多处理的日志条数，用于在多个日志器之间公平分配工作线程。
+ * format_threads 大于1时，最多这么多个工作线程可以同时格式化同一个日志器的不同批次，
+ * 每批日志取出时分配序号，格式化完成的批次按序号重排后写入接收器，输出顺序与单线程处理时完全一致。
+ * priority_lanes 为true时每个级别有自己的队列，积压时先取出高级别的日志，同一级别内保持入队顺序。
+ * shed_debug_watermark/shed_info_watermark/shed_warn_watermark 是逐级丢弃的队列长度水位（0表示不丢弃），
+ * 通常依次递增：积压达到第一个水位时丢弃DEBUG，继续增长时再丢弃INFO、WARN，ERROR和FATAL从不丢弃；
+ * 队列长度回落到最低水位以下后，日志器输出一条WARN日志汇总各级别丢弃的数量（日志器级别高于WARN时不输出），
+ * 这条日志不带线程信息和MDC，文件名为日志器名称、行号为0。
+ */
+
+namespace log{
+
+    struct AsyncOptions{
+        enum class WaitStrategy{
+            BusySpin,
+            SpinYield,
+            SpinPark,
+            TimedPoll
+        };
+
+        WaitStrategy wait = WaitStrategy::SpinPark;  // 等待策略
+        size_t spin_count = 2000;  // SpinYield/SpinPark 进入下一阶段前的自旋次数
+        std::chrono::microseconds poll_interval{1000};  // TimedPoll 的轮询间隔
+        int cpu = -1;  // 绑定的CPU编号，-1表示不绑定
+        int sched_policy = -1;  // 调度策略（SCHED_OTHER/SCHED_FIFO/SCHED_RR等），-1表示不修改
+        int sched_priority = 0;  // 调度优先级，取值范围由调度策略决定
+        size_t batch_size = 256;  // 每次轮到一个日志器时最多处理的日志条数
+        bool priority_lanes = false;  // 是否按级别分道，高级别优先处理
+        size_t shed_debug_watermark = 0;  // 队列长度达到此值时丢弃DEBUG（及UNKNOWN）日志
+        size_t shed_info_watermark = 0;  // 队列长度达到此值时丢弃INFO日志
+        size_t shed_warn_watermark = 0;  // 队列长度达到此值时丢弃WARN日志
+        size_t format_threads = 1;  // 同时格式化同一个日志器的最大工作线程数，私有执行器按此数量创建线程
+    };
+
+    // 自旋等待时提示CPU降低功耗并让出流水线
+    inline void CpuRelax(){
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    // 按配置设置线程的CPU亲和性和调度优先级，失败时抛出异常
+    inline void ApplyThreadOptions(std::thread& thread, const AsyncOptions& options){
+        if (options.cpu >= CPU_SETSIZE) {
+            throw std::runtime_error("Invalid log thread cpu: " + std::to_string(options.cpu));
+        }
+        if (options.cpu >= 0) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(options.cpu, &cpus);
+            int ret = pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+            if (ret != 0) {
+                throw std::runtime_error("Failed to set log thread affinity to cpu " + std::to_string(options.cpu) + ": " + std::strerror(ret));
+            }
+        }
+        if (options.sched_policy >= 0) {
+            sched_param param{};
+            param.sched_priority = options.sched_priority;
+            int ret = pthread_setschedparam(thread.native_handle(), options.sched_policy, &param);
+            if (ret != 0) {
+                throw std::runtime_error("Failed to set log thread scheduling: " + std::string(std::strerror(ret)));
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,97 @@
+#pragma once
+
+#ifndef __CLOCK_H__
+#define __CLOCK_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+ * Clock为日志消息提供时间戳。默认使用系统时钟（CLOCK_REALTIME，纳秒精度）；
+ * 调用 Clock::UseTSC() 后改为在生产者线程读取CPU时间戳计数器（rdtsc，不支持不变TSC的平台退回steady_clock），
+ * 由后台线程定期用系统时间校准，换算成墙上时间的工作推迟到格式化时（通常在后台线程）进行。
+ * 计数器频率按 CLOCK_MONOTONIC_RAW 测量，不受NTP的跳变和微调影响；系统时间只决定换算结果追赶的目标。
+ * 校准结果按分段线性函数保存：每段在起点与上一段相接且斜率为正，同一计数值总是换算成同一时间，
+ * 因此重新校准不会使时间戳倒退。
+ */
+
+namespace log{
+
+    class Clock{
+        public:
+            // 原始时间戳，tsc为false时value是自1970年以来的纳秒数
+            struct Timestamp{
+                uint64_t value = 0;
+                bool tsc = false;
+            };
+
+            static Timestamp Now()  // 获取当前时间戳
+            {
+                Source source = _source.load(std::memory_order_relaxed);
+                if (source == Source::System) {
+                    return Timestamp{SystemNanoseconds(), false};
+                }
+                return Timestamp{ReadCounter(source), true};
+            }
+
+            static int64_t ToNanoseconds(const Timestamp& ts);  // 换算成自1970年以来的纳秒数
+            static time_t ToTime_t(const Timestamp& ts) { return static_cast<time_t>(ToNanoseconds(ts) / 1000000000); }
+            // 用于测量耗时的单调计数，tsc为false时value是steady_clock的纳秒数
+            struct Tick{
+                uint64_t value = 0;
+                bool tsc = false;
+            };
+
+            // 读取单调计数：使用TSC时钟时读取CPU时间戳计数器，否则读取steady_clock，都不受系统时间调整的影响
+            static Tick MonotonicNow()
+            {
+                if (_source.load(std::memory_order_relaxed) == Source::TSC) {
+                    return Tick{ReadCounter(Source::TSC), true};
+                }
+                return Tick{ReadCounter(Source::Steady), false};
+            }
+
+            // 两次单调计数之间的纳秒数：先对原始计数做差，再按实测频率换算一次；期间切换了时钟时返回0
+            static int64_t Elapsed(const Tick& start, const Tick& end);
+
+            // 切换到TSC时钟并启动后台校准线程，interval为校准间隔；应在开始记录日志前调用
+            static void UseTSC(std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+            static bool IsTSC() { return _source.load(std::memory_order_relaxed) != Source::System; }
+
+            static uint64_t SystemNanoseconds()  // 系统时钟的当前时间（纳秒）
+            {
+                struct timespec ts{};
+                clock_gettime(CLOCK_REALTIME, &ts);
+                return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+            }
+
+        private:
+            enum class Source{
+                System,  // 系统时钟
+                TSC,  // CPU时间戳计数器
+                Steady  // 不支持不变TSC时使用steady_clock
+            };
+
+            static uint64_t ReadCounter(Source source)  // 读取计数器
+            {
+#if defined(__x86_64__) || defined(__i386__)
+                if (source == Source::TSC) {
+                    return __rdtsc();
+                }
+#endif
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+            }
+
+            friend class ClockCalibrator;
+            static inline std::atomic<Source> _source{Source::System};  // 当前使用的时钟
+    };
+}
+
+#endif
@@ -10,7 +10,8 @@
 /*
  * FormatItem类用于定义日志格式化项的基类，派生类可以实现不同的日志格式化功能。
  * 例如，TimeFormatItem类可以格式化时间戳，LevelFormatItem类可以格式化日志级别，
- * LoggerFormatItem类可以格式化日志名称，ThreadFormatItem类可以格式化线程ID，
+ * LoggerFormatItem类可以格式化日志名称，ThreadFormatItem类可以格式化线程ID，ThreadNameFormatItem类可以格式化线程名，
+ * MDCFormatItem类可以格式化线程诊断上下文，
  * FileFormatItem类可以格式化文件名，LineFormatItem类可以格式化行号，
  * MessageFormatItem类可以格式化日志内容，TabFormatItem类可以格式化制表符，
  * NewlineFormatItem类可以格式化换行符，OtherFormatItem类可以格式化原始字符。
@@ -52,6 +53,21 @@ namespace log{
             void Format(std::ostream& out, const LogMsg& msg) override;
     };
 
+    // 线程名格式化子类
+    class ThreadNameFormatItem : public FormatItem{
+        public:
+            void Format(std::ostream& out, const LogMsg& msg) override;
+    };
+
+    // MDC格式化子类，key为空时输出全部键值对
+    class MDCFormatItem : public FormatItem{
+        public:
+            explicit MDCFormatItem(std::string key);
+            void Format(std::ostream& out, const LogMsg& msg) override;
+        private:
+            std::string _key;  // 要输出的键
+    };
+
     // 文件名格式化子类
     class FileFormatItem : public FormatItem{
         public:
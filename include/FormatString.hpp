@@ -0,0 +1,147 @@
+#pragma once
+
+#ifndef __FORMAT_STRING_H__
+#define __FORMAT_STRING_H__
+
+#include <version>
+
+/*
+ * FormatLocation用于支持 std::format 风格的日志调用：
+ *   logger->Info("conn {} took {:.3f} ms", id, ms);
+ * 格式化字符串在编译期按 std::format_string 的规则检查，调用位置由 std::source_location 自动捕获，
+ * 不再需要传入 __FILE__/__LINE__。日志内容通过 std::vformat_to 直接写入消息缓冲区。
+ *
+ * 为了兼容原有的 Info(__FILE__, __LINE__, args...) 调用方式，字符串常量调用统一走 FormatLocation：
+ * 字符串常量与调用位置的文件名（__FILE__）相同且第一个参数是整数时，在编译期判定为旧的 (文件名, 行号, 参数...) 调用，
+ * 其余参数必须可以通过 operator<< 输出，否则编译报错。
+ * 其他没有 '{' '}' 却以整数作为第一个参数的字符串常量（如 Info("retrying", 3)，或 Info("main.cpp", 10, ...) 这样
+ * 以其他字符串常量作为文件名的旧调用）有歧义，编译报错；需要指定文件名时传入非字符串常量，
+ * 如 Info(std::string_view("main.cpp"), 10, ...)。
+ * 非字符串常量（std::string、std::string_view、const char* 变量等）作为文件名的调用仍然使用原有的重载。
+ *
+ * 格式化后端：标准库支持 <format> 时使用 std::format；定义 LOG_USE_FMT（CMake 选项 LOG_USE_FMT）时使用 {fmt} 库，
+ * 使不支持 <format> 的标准库（如 libstdc++ 12）也能使用这种调用方式。两者都不可用时（LOG_HAS_FORMAT 为0），只提供原有的调用方式。
+ */
+
+#if defined(LOG_USE_FMT)
+#define LOG_HAS_FORMAT 1
+#elif defined(__cpp_lib_format) && __cpp_lib_format >= 202110L
+#define LOG_HAS_FORMAT 1
+#else
+#define LOG_HAS_FORMAT 0
+#endif
+
+#include <concepts>
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#if defined(LOG_USE_FMT)
+#include <fmt/core.h>  // 只使用 core.h：fmt/format.h 会引入 <cmath>，其中的 ::log 与本库的命名空间冲突
+#include <source_location>
+#elif LOG_HAS_FORMAT
+#include <format>
+#include <source_location>
+#endif
+
+namespace log{
+
+    // 可以通过 operator<< 输出的类型
+    template<class T>
+    concept Streamable = requires(std::ostream& out, const T& value) { out << value; };
+
+#if LOG_HAS_FORMAT
+
+    // 格式化后端
+    namespace format_api{
+#if defined(LOG_USE_FMT)
+        using ::fmt::format_string;
+        using ::fmt::make_format_args;
+        using ::fmt::vformat_to;
+
+        template<class T>
+        inline constexpr bool is_formattable = ::fmt::is_formattable<T>::value;
+#else
+        using ::std::format_string;
+        using ::std::make_format_args;
+        using ::std::vformat_to;
+
+        template<class T>
+        inline constexpr bool is_formattable = std::is_default_constructible_v<std::formatter<T, char>>;
+#endif
+    }
+
+    // 可以通过格式化后端输出的类型
+    template<class T>
+    concept Formattable = format_api::is_formattable<std::remove_cvref_t<T>>;
+
+    // 旧调用方式的文件名参数：字符串常量交给 FormatLocation
+    template<class File>
+    concept LegacyFile = std::convertible_to<const File&, std::string_view> && !std::is_array_v<std::remove_cvref_t<File>>;
+
+    // 格式化字符串和调用位置
+    template<class... Args>
+    class FormatLocation{
+        public:
+            template<size_t N>
+            consteval FormatLocation(const char (&str)[N], std::source_location loc = std::source_location::current())
+                : _str(str, N - 1), _loc(loc), _legacy(IsLegacy(std::string_view(str, N - 1), loc)) {
+                if (!_legacy) {
+                    if constexpr ((Formattable<Args> && ...)) {
+                        format_api::format_string<Args...> check(str);  // 编译期检查占位符与参数
+                        (void)check;
+                    } else {
+                        throw "log format arguments are not formattable";  // 在编译期报错
+                    }
+                }
+            }
+
+            std::string_view str() const { return _str; }  // 格式化字符串（旧调用方式下为文件名）
+            const std::source_location& location() const { return _loc; }  // 调用位置
+            bool legacy() const { return _legacy; }  // 是否为 (文件名, 行号, 参数...) 调用
+
+        private:
+            // 旧调用方式只接受调用位置的 __FILE__ 作为文件名，其余无占位符、以整数开头的调用在编译期报错
+            static consteval bool IsLegacy(std::string_view str, const std::source_location& loc) {
+                if constexpr (sizeof...(Args) == 0) {
+                    return false;
+                } else if constexpr (!std::is_integral_v<std::remove_cvref_t<std::tuple_element_t<0, std::tuple<Args...>>>>) {
+                    return false;
+                } else {
+                    if (str == std::string_view(loc.file_name())) {
+                        if (!LegacyStreamable<Args...>) {
+                            throw "legacy log call arguments are not streamable";  // 在编译期报错，而不是在运行时丢弃这条日志
+                        }
+                        return true;
+                    }
+                    if (str.find_first_of("{}") == std::string_view::npos) {
+                        throw "ambiguous log call: format string has no placeholders but arguments were given";  // 在编译期报错
+                    }
+                    return false;
+                }
+            }
+
+            // 旧调用方式中行号之后的参数都可以通过 operator<< 输出
+            template<class Line, class... Rest>
+            static constexpr bool LegacyStreamable = (Streamable<std::remove_cvref_t<Rest>> && ...);
+
+            std::string_view _str;
+            std::source_location _loc;
+            bool _legacy;
+    };
+
+    // 参数类型不参与推导，由后面的实参决定
+    template<class... Args>
+    using format_location = FormatLocation<std::type_identity_t<Args>...>;
+
+#else
+
+    template<class File>
+    concept LegacyFile = std::convertible_to<const File&, std::string_view>;
+
+#endif
+}
+
+#endif
@@ -11,6 +11,7 @@
 /*
     * Formatter类用于格式化日志消息，将其转换为指定的字符串格式。
     * 它支持自定义格式化模式，可以包含时间戳、日志级别、日志名称、线程ID、文件名、行号和日志内容等信息。
+    * 线程相关的格式化项：%t 线程号、%N 线程名、%X{key} MDC中指定键的值、%X 全部MDC键值对。
     * 通过解析格式化模式字符串，Formatter可以动态创建对应的格式化项，并在格式化日志消息时调用这些项的Format方法。
     * 使用Formatter时，可以通过传入一个日志格式化模式字符串来指定日志的输出格式。
  */
@@ -24,6 +25,7 @@ namespace log{
             Formatter(std::string pattern);
             void Format(std::ostream& out, const LogMsg& msg) const; // 格式化日志消息并输出到指定的输出流中
             std::string Format(const LogMsg& msg) const; // 将日志消息格式化为字符串并返回
+            void Format(std::string& out, const LogMsg& msg) const; // 将日志消息格式化后追加到out，复用其容量
 
         private:
             bool ParsePattern(); // 解析日志格式化模式字符串，将其转换为对应的格式化项
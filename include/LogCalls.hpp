@@ -0,0 +1,178 @@
+#pragma once
+
+#ifndef __LOG_CALLS_H__
+#define __LOG_CALLS_H__
+
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "FormatString.hpp"
+#include "Level.hpp"
+#include "MsgPool.hpp"
+#include "Util.hpp"
+
+/*
+ * LogCalls是Logger和StaticLogger共用的日志调用接口（CRTP）：
+ * 每个级别提供 (文件名, 行号, 参数...) 形式的调用，格式化后端可用时还提供 std::format 风格的调用，
+ * 两种调用方式的区分（见FormatString.hpp）只在这里实现一次。
+ * 派生类需要提供（可以是私有的，并将 LogCalls<Derived> 声明为友元）：
+ *   bool levelEnabled(LogLevel::Level level) const;  // 该级别是否需要记录
+ *   const std::string& loggerName() const;  // 日志器名称
+ *   void dispatchLog(MsgBuffer::ptr buf);  // 写入接收器
+ */
+
+namespace log{
+
+    template<class Derived>
+    class LogCalls{
+        public:
+            //可变参数模板，用于设置UNKNOWN级别日志
+            template<LegacyFile File, class... Args>
+            void Unknown(const File& file, size_t line, const Args&... args) {
+                LogtoLevel(LogLevel::Level::UNKNOWN, file, line, args...);
+            }
+#if LOG_HAS_FORMAT
+            // std::format 风格，用于 UNKNOWN级别日志，调用位置自动捕获
+            template<class... Args>
+            void Unknown(format_location<Args...> fmt, Args&&... args) {
+                FormatToLevel(LogLevel::Level::UNKNOWN, fmt, std::forward<Args>(args)...);
+            }
+#endif
+
+            // 可变参数模板，用于 Debug 级别日志
+            template<LegacyFile File, class... Args>
+            void Debug(const File& file, size_t line, const Args&... args) {
+                LogtoLevel(LogLevel::Level::DEBUG, file, line, args...);
+            }
+#if LOG_HAS_FORMAT
+            // std::format 风格，用于 Debug 级别日志，调用位置自动捕获
+            template<class... Args>
+            void Debug(format_location<Args...> fmt, Args&&... args) {
+                FormatToLevel(LogLevel::Level::DEBUG, fmt, std::forward<Args>(args)...);
+            }
+#endif
+
+            // 可变参数模板，用于 Info 级别日志
+            template<LegacyFile File, class... Args>
+            void Info(const File& file, size_t line, const Args&... args) {
+                LogtoLevel(LogLevel::Level::INFO, file, line, args...);
+            }
+#if LOG_HAS_FORMAT
+            // std::format 风格，用于 Info 级别日志，调用位置自动捕获
+            template<class... Args>
+            void Info(format_location<Args...> fmt, Args&&... args) {
+                FormatToLevel(LogLevel::Level::INFO, fmt, std::forward<Args>(args)...);
+            }
+#endif
+
+            // 可变参数模板，用于 Warn 级别日志
+            template<LegacyFile File, class... Args>
+            void Warn(const File& file, size_t line, const Args&... args) {
+                LogtoLevel(LogLevel::Level::WARN, file, line, args...);
+            }
+#if LOG_HAS_FORMAT
+            // std::format 风格，用于 Warn 级别日志，调用位置自动捕获
+            template<class... Args>
+            void Warn(format_location<Args...> fmt, Args&&... args) {
+                FormatToLevel(LogLevel::Level::WARN, fmt, std::forward<Args>(args)...);
+            }
+#endif
+
+            // 可变参数模板，用于 Error 级别日志
+            template<LegacyFile File, class... Args>
+            void Error(const File& file, size_t line, const Args&... args) {
+                LogtoLevel(LogLevel::Level::ERROR, file, line, args...);
+            }
+#if LOG_HAS_FORMAT
+            // std::format 风格，用于 Error 级别日志，调用位置自动捕获
+            template<class... Args>
+            void Error(format_location<Args...> fmt, Args&&... args) {
+                FormatToLevel(LogLevel::Level::ERROR, fmt, std::forward<Args>(args)...);
+            }
+#endif
+
+            // 可变参数模板，用于 Fatal 级别日志
+            template<LegacyFile File, class... Args>
+            void Fatal(const File& file, size_t line, const Args&... args) {
+                LogtoLevel(LogLevel::Level::FATAL, file, line, args...);
+            }
+#if LOG_HAS_FORMAT
+            // std::format 风格，用于 Fatal 级别日志，调用位置自动捕获
+            template<class... Args>
+            void Fatal(format_location<Args...> fmt, Args&&... args) {
+                FormatToLevel(LogLevel::Level::FATAL, fmt, std::forward<Args>(args)...);
+            }
+#endif
+
+            //可变参数模板，用于 Off 级别日志
+            template<LegacyFile File, class... Args>
+            void OFF(const File& file, size_t line, const Args&... args) {
+                LogtoLevel(LogLevel::Level::OFF, file, line, args...);
+            }
+#if LOG_HAS_FORMAT
+            // std::format 风格，用于 Off 级别日志，调用位置自动捕获
+            template<class... Args>
+            void OFF(format_location<Args...> fmt, Args&&... args) {
+                FormatToLevel(LogLevel::Level::OFF, fmt, std::forward<Args>(args)...);
+            }
+#endif
+
+        protected:
+            LogCalls() = default;
+            ~LogCalls() = default;
+
+        private:
+            Derived& derived() { return static_cast<Derived&>(*this); }
+
+            template<class... Args>
+            void LogtoLevel(LogLevel::Level level, std::string_view file, size_t line, const Args&... args) {
+                // 1. 低于日志器级别或所有接收器的级别，则不记录日志
+                if (!derived().levelEnabled(level)) {
+                    return;
+                }
+                // 2. 从缓冲池获取日志消息对象，复用其中的字符串容量
+                MsgBuffer::ptr buf = MsgPool::Acquire();
+                buf->msg.reset(level, derived().loggerName(), file, line);
+                // 3. 直接在消息缓冲区中构造日志消息主体，C++17 折叠表达式将所有参数写入流
+                AppendStream ss(buf->msg.getPayloadBuffer());
+                (ss << ... << args);
+                // 4. 按各接收器的格式发送
+                derived().dispatchLog(std::move(buf));
+            }
+
+#if LOG_HAS_FORMAT
+            // std::format 风格的日志：编译期检查过的格式化字符串直接写入消息缓冲区
+            template<class... Args>
+            void FormatToLevel(LogLevel::Level level, const FormatLocation<Args...>& fmt, Args&&... args) {
+                if (fmt.legacy()) {
+                    // 字符串常量作为文件名的旧调用方式：(文件名, 行号, 参数...)，参数已在编译期检查
+                    if constexpr (sizeof...(Args) > 0) {
+                        legacyToLevel(level, fmt.str(), args...);
+                    }
+                    return;
+                }
+                if (!derived().levelEnabled(level)) {
+                    return;
+                }
+                if constexpr ((Formattable<Args> && ...)) {
+                    MsgBuffer::ptr buf = MsgPool::Acquire();
+                    buf->msg.reset(level, derived().loggerName(), fmt.location().file_name(), fmt.location().line());
+                    format_api::vformat_to(std::back_inserter(buf->msg.getPayloadBuffer()), fmt.str(), format_api::make_format_args(args...));
+                    derived().dispatchLog(std::move(buf));
+                }
+            }
+
+            // FormatLocation 只在第一个参数是整数、其余参数可输出时判定为旧调用，其他组合不会走到这里
+            template<class Line, class... Rest>
+            void legacyToLevel(LogLevel::Level level, std::string_view file, const Line& line, const Rest&... rest) {
+                if constexpr (std::is_integral_v<Line> && (Streamable<Rest> && ...)) {
+                    LogtoLevel(level, file, static_cast<size_t>(line), rest...);
+                }
+            }
+#endif
+    };
+}
+
+#endif
@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef __LOG_EXECUTOR_H__
+#define __LOG_EXECUTOR_H__
+
+#include <array>
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncOptions.hpp"
+
+/*
+ * LogExecutor是异步日志的后台工作线程池，任意数量的AsyncLogger可以共享同一个执行器，
+ * 避免每个日志器各自占用一个大部分时间空闲的线程。
+ * 每个AsyncLogger仍然有自己的队列：同一时刻只有一个工作线程处理某个日志器，保证单个日志器内的顺序；
+ * 有待处理日志的日志器按轮转顺序排队，每次最多处理 batch_size 条后重新排到队尾，使各日志器公平地分享工作线程。
+ * 工作线程一轮会取出多个日志器，把写往同一个接收器的日志合并成一次写入。
+ * 等待策略、CPU绑定和调度优先级沿用AsyncOptions，多个工作线程时第i个线程绑定到 cpu + i。
+ * format_threads 大于1时切换到并行格式化模式：工作线程取出一批日志后立即把日志器重新排队，
+ * 其他工作线程可以同时格式化后续批次；每批取出时分配序号，格式化完成的批次进入日志器的重排缓冲区，
+ * 由恰好轮到下一个序号的工作线程按取出顺序依次写入接收器，其他线程不必等待。
+ */
+
+namespace log{
+
+    class AsyncLogger;
+    class Formatter;
+    class LogSink;
+
+    class LogExecutor{
+        public:
+            using ptr = std::shared_ptr<LogExecutor>;
+            static constexpr size_t kLoggersPerRound = 8;  // 每轮最多合并处理的日志器数量
+
+            explicit LogExecutor(size_t threads = 1, AsyncOptions options = {});
+            ~LogExecutor();
+            LogExecutor(const LogExecutor&) = delete;
+            LogExecutor& operator=(const LogExecutor&) = delete;
+
+            void Schedule(AsyncLogger* logger);  // 将有待处理日志的日志器加入就绪队列
+            size_t GetThreadCount() const { return _threads.size(); }
+            const AsyncOptions& GetOptions() const { return _options; }
+
+        private:
+            friend class AsyncLogger;
+
+            // 写往同一个接收器的合并缓冲区
+            struct SinkBatch{
+                LogSink* sink = nullptr;
+                std::string data;
+            };
+
+            // 并行格式化模式下已经格式化、等待按序写入的一批日志
+            struct OrderedBatch{
+                uint64_t seq = 0;  // 批次的序号
+                std::vector<SinkBatch> sinks;  // 按接收器合并的输出，复用容量
+                size_t used = 0;  // sinks 中本批使用的数量
+                OrderedBatch* next = nullptr;
+            };
+
+            // 日志器的重排缓冲区，每个AsyncLogger一个
+            struct ReorderBuffer{
+                std::mutex mutex;
+                uint64_t next_seq = 0;  // 下一批应写入的批次序号
+                bool emitting = false;  // 是否有工作线程正在按序写入
+                OrderedBatch* pending = nullptr;  // 等待写入的批次，按序号排列
+                OrderedBatch* free = nullptr;  // 可复用的批次
+                std::vector<std::unique_ptr<OrderedBatch>> storage;  // 批次的所有权，数量不超过 format_threads
+            };
+
+            // 工作线程并行格式化时使用的私有数据
+            struct FormatScratch{
+                std::vector<std::shared_ptr<LogSink>> sinks;  // 日志器接收器列表的快照
+                std::vector<std::pair<std::shared_ptr<Formatter>, std::string>> cache;  // 格式化结果缓存
+            };
+
+            void stop();
+            void workerLoop();
+            bool waitForWork();  // 按等待策略等待就绪的日志器，停止运行且没有待处理的日志器时返回false
+            void park();
+            size_t claim(AsyncLogger** loggers, size_t max);  // 从就绪队列头部取出最多max个日志器
+            std::mutex& sinkLock(const LogSink* sink);  // 接收器的写入锁，多个工作线程可能写同一个接收器
+            void processOrdered(AsyncLogger* logger, FormatScratch& scratch);  // 并行格式化模式下处理日志器的一批日志
+            size_t emitOrdered(ReorderBuffer& reorder, OrderedBatch* batch);  // 提交格式化完成的批次，返回本线程按序写入的批次数
+
+            AsyncOptions _options;
+            std::vector<std::thread> _threads;
+            std::mutex _mutex;  // 保护就绪队列
+            std::condition_variable _cond_var;
+            std::atomic<AsyncLogger*> _ready_head{nullptr};  // 就绪队列头，工作线程自旋时无锁检查
+            AsyncLogger* _ready_tail = nullptr;  // 就绪队列尾
+            size_t _parked = 0;  // 正在条件变量上休眠的工作线程数，受 _mutex 保护
+            std::atomic<bool> _running{true};
+            std::array<std::mutex, 16> _sink_locks;  // 按接收器地址分段的写入锁
+    };
+}
+
+#endif
@@ -6,24 +6,142 @@
 #include <iostream>
 #include <memory>
 #include "Util.hpp"
+#include "Level.hpp"
+#include "Formatter.hpp"
 #include <fstream>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
 
 
 /*
  * LogSink类用于定义日志接收器的接口，派生类可以实现不同的日志输出方式。
  * 例如，StdOutSink类可以将日志输出到标准输出，FileSink类可以将日志写入文件，
- * RollBySizeSink类可以根据文件大小进行日志轮转。
+ * RollBySizeSink类可以根据文件大小进行日志轮转，SharedFileSink类可以让多个进程安全地写入同一组轮转日志文件。
  * 通过使用LogSink类，用户可以灵活地选择日志输出方式，以满足不同的需求。
+ * 每个接收器可以单独设置级别阈值、过滤器（按日志器名称前缀或源码文件）和格式化器，
+ * 未设置格式化器时使用Logger的格式化器。
  *
 */
 namespace log{
 
+    // 日志过滤器，构造时确定匹配规则，匹配时只做一次前缀/后缀比较
+    class LogFilter{
+        public:
+            using ptr = std::shared_ptr<LogFilter>;
+            enum class Type{
+                LoggerPrefix,  // 日志器名称以指定前缀开头
+                SourceFile  // 源码文件路径以指定文件名结尾
+            };
+            LogFilter(Type type, std::string pattern);
+            bool Match(const LogMsg& msg) const;  // 判断日志消息是否通过过滤
+
+            static ptr LoggerPrefix(std::string prefix) { return std::make_shared<LogFilter>(Type::LoggerPrefix, std::move(prefix)); }
+            static ptr SourceFile(std::string file) { return std::make_shared<LogFilter>(Type::SourceFile, std::move(file)); }
+
+        private:
+            Type _type;  // 匹配类型
+            std::string _pattern;  // 匹配模式
+    };
+
+    // 接收器级别变化的监听者（日志器），接收器级别修改后重新计算自己的有效阈值
+    class LevelListener{
+        public:
+            virtual void RefreshLevel() = 0;
+
+        protected:
+            ~LevelListener() = default;
+    };
+
+    // 可在运行中替换的共享对象：读取时复制一份 shared_ptr，替换时旧对象在所有引用释放后销毁
+    template<class T>
+    class SharedSetting{
+        public:
+            std::shared_ptr<T> Load() const {
+                std::lock_guard<std::mutex> lock(_mutex);
+                return _value;
+            }
+
+            void Store(std::shared_ptr<T> value) {
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _value.swap(value);
+                }
+                // 旧对象的引用在锁外释放
+            }
+
+        private:
+            mutable std::mutex _mutex;
+            std::shared_ptr<T> _value;
+    };
+
     // 日志接收器基类，定义了日志接收器的接口
+    // 级别、过滤器和格式化器可以在日志记录过程中随时修改：级别是原子变量，修改后通知所属的日志器；
+    // 过滤器和格式化器由 SharedSetting 保存，读取的线程持有引用直到用完，被替换的对象在最后一个使用它的线程用完后释放。
     class LogSink{
         public:
             using ptr = std::shared_ptr<LogSink>;
+            LogSink() = default;
+            LogSink(const LogSink&) = delete;
+            LogSink& operator=(const LogSink&) = delete;
             virtual ~LogSink() = default;  // 虚析构函数，确保派生类的析构函数被调用
             virtual void LogtoSink(const char* data, size_t len) = 0;  // 纯虚函数，派生类必须实现该方法来处理日志消息
+
+            // 设置接收器的级别阈值，并更新所属日志器的有效阈值
+            void SetLevel(LogLevel::Level level) {
+                _level.store(level, std::memory_order_relaxed);
+                std::lock_guard<std::mutex> lock(_config_mutex);
+                for (LevelListener* listener : _listeners) {
+                    listener->RefreshLevel();
+                }
+            }
+            LogLevel::Level GetLevel() const { return _level.load(std::memory_order_relaxed); }
+
+            // 设置过滤器，nullptr表示不过滤
+            void SetFilter(LogFilter::ptr filter) {
+                _filter.Store(std::move(filter));
+            }
+
+            // 设置格式化器，nullptr表示使用Logger的格式化器
+            void SetFormatter(Formatter::ptr formatter) {
+                _formatter.Store(std::move(formatter));
+            }
+            Formatter::ptr GetFormatter() const { return _formatter.Load(); }
+
+            // 判断日志消息是否需要写入该接收器
+            bool ShouldLog(const LogMsg& msg) const {
+                if (msg.getLevel() < GetLevel()) {
+                    return false;
+                }
+                LogFilter::ptr filter = _filter.Load();
+                return !filter || filter->Match(msg);
+            }
+
+            // 注册/注销级别变化的监听者，由日志器在添加接收器和析构时调用
+            void AddListener(LevelListener* listener) {
+                std::lock_guard<std::mutex> lock(_config_mutex);
+                _listeners.push_back(listener);
+            }
+            void RemoveListener(LevelListener* listener) {
+                std::lock_guard<std::mutex> lock(_config_mutex);
+                for (auto it = _listeners.begin(); it != _listeners.end(); ++it) {
+                    if (*it == listener) {
+                        _listeners.erase(it);  // 同一日志器可能添加同一接收器多次，每次只注销一个
+                        break;
+                    }
+                }
+            }
+
+        protected:
+            std::atomic<LogLevel::Level> _level{LogLevel::Level::UNKNOWN};  // 级别阈值
+            SharedSetting<LogFilter> _filter;  // 过滤器
+            SharedSetting<Formatter> _formatter;  // 格式化器
+
+        private:
+            std::mutex _config_mutex;  // 保护 _listeners
+            std::vector<LevelListener*> _listeners;  // 使用该接收器的日志器
     };
 
     class StdOutSink : public LogSink{
@@ -59,6 +177,32 @@ namespace log{
             std::ofstream _ofs; // 文件输出流
             size_t _count; // 文件名计数器
     };
+
+    // 多进程共享的轮转日志接收器
+    // 每条日志通过一次 O_APPEND 的 write 写入，多个进程的日志行不会交错；
+    // 轮转由映射到共享内存的控制块协调：控制块中的一个原子字同时保存代数(generation)和当前文件大小，
+    // 写入前通过CAS预留空间，超过上限的那次预留把代数加一，各进程发现代数变化后自行重新打开文件，无需全局锁。
+    // 文件名与RollBySizeSink相同：basename_<代数>.log，控制块保存在 basename.ctl 中，该文件初始化完成后才原子地出现。
+    // 同一进程内多个日志器共享一个接收器时，写入与切换文件之间由读写锁互斥。
+    class SharedFileSink : public LogSink{
+        public:
+            SharedFileSink(const std::string& basename, size_t max_size);
+            ~SharedFileSink() override;
+            void LogtoSink(const char* data, size_t len) override;
+
+        private:
+            struct Control; // 共享控制块
+
+            void Reopen(uint64_t generation); // 打开指定代数的日志文件
+            std::string GetFileName(uint64_t generation) const; // 获取指定代数的文件名
+
+            std::string _basename; // 基础文件名
+            size_t _max_size; // 最大文件大小
+            Control* _control = nullptr; // 映射到共享内存的控制块
+            std::shared_mutex _fd_mutex; // 写入持有共享锁，重新打开文件持有独占锁
+            int _fd = -1; // 当前日志文件，受 _fd_mutex 保护
+            uint64_t _generation = 0; // 当前打开文件的代数，受 _fd_mutex 保护
+    };
 }
 
 #endif
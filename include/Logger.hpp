@@ -7,118 +7,141 @@
 #include "Formatter.hpp"
 #include "LogSink.hpp"
 #include "Message.hpp"
+#include "MsgPool.hpp"
+#include "LogCalls.hpp"
 
+#include <atomic>
 #include <mutex>
-#include <sstream>
+#include <string_view>
 
 /*
  * Logger类用于记录日志消息，支持多种日志级别（DEBUG、INFO、WARN、ERROR、FATAL）。
- * 它提供了可变参数模板方法，允许用户以不同的方式记录日志消息。
+ * 它提供了可变参数模板方法（由LogCalls提供，与StaticLogger共用），允许用户以不同的方式记录日志消息。
  * Logger可以添加多个日志接收器（Sink），如标准输出、文件输出等。
  * 通过使用Formatter，Logger可以格式化日志消息的输出格式。
+ * Logger维护自身级别与所有接收器级别中的最小有效阈值，低于阈值的调用直接返回；
+ * 分发时每个不同的格式化器只格式化一次，结果由使用同一格式化器的接收器共享。
+ * 日志消息从MsgPool中获取并直接写入其缓冲区，稳定状态下一条日志不分配内存。
+ * 标准库支持 <format> 时，还可以使用 Info("conn {} took {:.3f} ms", id, ms) 形式的调用（见FormatString.hpp）。
  *
  */
 
 namespace log{
 
-    class Logger{
+    class Logger : public LevelListener, public LogCalls<Logger>{
 
         public:
 
             Logger(const std::string& name = "root", LogLevel::Level level = LogLevel::Level::UNKNOWN,
                    Formatter::ptr formatter = nullptr, std::vector<LogSink::ptr> sinks = {})
-                : _logger(name), _level(level) {
-                // 设置一个默认的格式化器
-                _formatter = std::make_shared<Formatter>("%d{%H:%M:%S}[%p][%c][%f:%l]%T%m%n");
-            }
-
-            virtual ~Logger() = default;
-            using ptr = std::shared_ptr<Logger>;
-
-            //可变参数模板，用于设置UNKNOWN级别日志
-            template<class... Args>
-            void Unknown(const std::string& file, size_t line, const Args&... args) {
-                LogtoLevel(LogLevel::Level::UNKNOWN, file, line, args...);
+                : _logger(name), _level(level), _threshold(level), _formatter(std::move(formatter)), _sinks(std::move(sinks)) {
+                if (!_formatter) {
+                    // 设置一个默认的格式化器
+                    _formatter = std::make_shared<Formatter>("%d{%H:%M:%S}[%p][%c][%f:%l]%T%m%n");
+                }
+                for (auto& sink : _sinks) {
+                    sink->AddListener(this);  // 接收器级别修改后更新有效阈值
+                }
+                RefreshLevel();
             }
 
-            // 可变参数模板，用于 Debug 级别日志
-            template<class... Args>
-            void Debug(const std::string& file, size_t line, const Args&... args) {
-                LogtoLevel(LogLevel::Level::DEBUG, file, line, args...);
+            virtual ~Logger() {
+                for (auto& sink : _sinks) {
+                    sink->RemoveListener(this);
+                }
             }
+            using ptr = std::shared_ptr<Logger>;
 
-            // 可变参数模板，用于 Info 级别日志
-            template<class... Args>
-            void Info(const std::string& file, size_t line, const Args&... args) {
-                    LogtoLevel(LogLevel::Level::INFO, file, line, args...);
+            // 添加 LogSink
+            void AddSink(LogSink::ptr sink) {
+                    sink->AddListener(this);  // 先注册，之后对接收器级别的修改都会反映到有效阈值
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _sinks.push_back(sink);
+                    refreshThreshold();
             }
 
-            // 可变参数模板，用于 Warn 级别日志
-            template<class... Args>
-            void Warn(const std::string& file, size_t line, const Args&... args) {
-                    LogtoLevel(LogLevel::Level::WARN, file, line, args...);
+            // 重新计算有效级别阈值，接收器的级别修改时自动调用
+            void RefreshLevel() override {
+                std::unique_lock<std::mutex> lock(_mutex);
+                refreshThreshold();
             }
 
-            // 可变参数模板，用于 Error 级别日志
-            template<class... Args>
-            void Error(const std::string& file, size_t line, const Args&... args) {
-                    LogtoLevel(LogLevel::Level::ERROR, file, line, args...);
+        protected:
+            // 分发日志消息到所有接收器
+            virtual void dispatchLog(MsgBuffer::ptr buf){
+                std::unique_lock<std::mutex> lock(_mutex);
+                writeToSinks(buf->msg);
             }
 
-            // 可变参数模板，用于 Fatal 级别日志
-            template<class... Args>
-            void Fatal(const std::string& file, size_t line, const Args&... args) {
-                    LogtoLevel(LogLevel::Level::FATAL, file, line, args...);
+            // 按接收器的级别和过滤器写入日志，调用者需保证对 _sinks 的独占访问
+            void writeToSinks(const LogMsg& msg) {
+                formatForSinks(msg, [](LogSink& sink, const std::string& formatted_msg) {
+                    sink.LogtoSink(formatted_msg.c_str(), formatted_msg.length());
+                });
             }
 
-            //可变参数模板，用于 Off 级别日志
-            template<class... Args>
-            void OFF(const std::string& file, size_t line, const Args&... args) {
-                    LogtoLevel(LogLevel::Level::OFF, file, line, args...);
-            }
+            using FormatCache = std::vector<std::pair<Formatter::ptr, std::string>>; // 格式化结果缓存，按格式化器区分，持有格式化器的引用
 
-            // 添加 LogSink
-            void AddSink(LogSink::ptr sink) {
-                    std::unique_lock<std::mutex> lock(_mutex);
-                    _sinks.push_back(sink);
+            // 为每个需要该消息的接收器生成输出并交给writer，每个不同的格式化器只格式化一次，调用者需保证对 _sinks 的独占访问
+            template<class Writer>
+            void formatForSinks(const LogMsg& msg, Writer&& writer) {
+                formatForSinks(_sinks, _formatted, msg, std::forward<Writer>(writer));
             }
 
-        protected:
-            // 分发日志消息到所有接收器
-            virtual void dispatchLog(const std::string& formatted_msg){
-                std::unique_lock<std::mutex> lock(_mutex);
-                for (auto& sink : _sinks) {
-                    sink->LogtoSink(formatted_msg.c_str(), formatted_msg.length());
+            // 同上，使用给定的接收器列表和缓存，供多个线程同时格式化同一个日志器的消息
+            template<class Writer>
+            void formatForSinks(const std::vector<LogSink::ptr>& sinks, FormatCache& cache, const LogMsg& msg, Writer&& writer) const {
+                size_t used = 0;  // 本条消息已经使用的缓存项数量
+                for (auto& sink : sinks) {
+                    if (!sink->ShouldLog(msg)) {
+                        continue;
+                    }
+                    Formatter::ptr sink_formatter = sink->GetFormatter();
+                    const Formatter::ptr& formatter = sink_formatter ? sink_formatter : _formatter;
+                    size_t i = 0;
+                    while (i < used && cache[i].first != formatter) {
+                        i++;
+                    }
+                    if (i == used) {
+                        // 该格式化器第一次出现，格式化并缓存结果
+                        if (used == cache.size()) {
+                            cache.emplace_back();
+                        }
+                        cache[used].first = formatter;
+                        cache[used].second.clear();  // 保留上次的容量
+                        formatter->Format(cache[used].second, msg);
+                        used++;
+                    }
+                    writer(*sink, cache[i].second);
                 }
             }
-        
-        
+
             std::mutex _mutex; // 互斥锁，确保多线程环境下的安全访问
             std::string _logger; // 日志记录器名称
             LogLevel::Level _level; // 日志级别
+            std::atomic<LogLevel::Level> _threshold; // 有效级别阈值：日志器级别与接收器最低级别中的较大者
             Formatter::ptr _formatter; // 日志格式化器
             std::vector<LogSink::ptr> _sinks; // 日志接收器列表
+            FormatCache _formatted; // 格式化结果缓存
 
         private:
-            template<class... Args>
-            void LogtoLevel(LogLevel::Level level, const std::string& file, size_t line, const Args&... args) {
-                // 1. 判断日志级别是否需要记录
-                if (level < _level) {  // 如果当前日志级别低于 Logger 的级别，则不记录日志
-                    return;
+            // 重新计算有效级别阈值，调用者需持有 _mutex
+            void refreshThreshold() {
+                LogLevel::Level sink_level = LogLevel::Level::OFF;
+                for (auto& sink : _sinks) {
+                    if (sink->GetLevel() < sink_level) {
+                        sink_level = sink->GetLevel();
+                    }
                 }
-
-                // 2. 使用 stringstream 构造日志消息主体
-                std::stringstream ss;
-                // C++17 折叠表达式，将所有参数写入流
-                (ss << ... << args);
-                // 3. 创建日志消息对象
-                LogMsg msg(level, _logger, file, line, ss.str());
-                // 4. 使用格式化器生成最终日志字符串
-                std::string formatted_msg = _formatter->Format(msg);
-                // 5. 调用 dispatchLog 方法将格式化后的日志消息发送到所有接收器
-                dispatchLog(formatted_msg);
+                _threshold.store(sink_level > _level ? sink_level : _level, std::memory_order_relaxed);
             }
 
+            // LogCalls 使用的钩子
+            friend class LogCalls<Logger>;
+            bool levelEnabled(LogLevel::Level level) const {
+                return level >= _threshold.load(std::memory_order_relaxed);
+            }
+            const std::string& loggerName() const { return _logger; }
     };
 
 
@@ -5,12 +5,16 @@
 
 #include "Util.hpp"
 #include "Level.hpp"
+#include "ThreadContext.hpp"
+#include "Clock.hpp"
+#include <string_view>
 #include <thread>
 #include <utility>
 
 /*
  * LogMsg类用于表示一条日志消息，包含时间戳、日志级别、日志名称、线程ID、源码文件名、源码行号和日志内容等信息。
  * 它提供了获取和设置这些信息的方法，方便在日志系统中使用。
+ * 线程信息和MDC快照在构造时于生产者线程捕获（只拷贝指针），即使在后台线程格式化也输出生产者的信息。
  *
 */
 namespace log{
@@ -19,11 +23,13 @@ namespace log{
 
         public:
 
-            LogMsg() : _ctime(Date::Now()),
+            LogMsg() : _ctime(Clock::Now()),
                 _level(LogLevel::UNKNOWN),
                 _logger("root"),
                 _file(""),
                 _tID(std::this_thread::get_id()),
+                _thread(ThreadInfo::Current()),
+                _mdc(MDC::Current()),
                 _line(0),
                 _payload(""){}
 
@@ -32,37 +38,68 @@ namespace log{
                 std::string file,
                 size_t line,
                 std::string  payload
-                ) : _ctime(Date::Now()),
+                ) : _ctime(Clock::Now()),
                     _level(level),
                     _logger(std::move(logger)),
                     _file(std::move(file)),
                     _tID(std::this_thread::get_id()),
+                    _thread(ThreadInfo::Current()),
+                    _mdc(MDC::Current()),
                     _line(line),
                     _payload(std::move(payload)){}
             ~LogMsg(){}
 
-            time_t getTime_t() const { return _ctime; }  //获取时间戳
+            // 复用已有的字符串容量重新填充消息（用于消息缓冲池），内容由调用者写入 getPayloadBuffer()
+            void reset(LogLevel::Level level, std::string_view logger, std::string_view file, size_t line) {
+                _ctime = Clock::Now();
+                _level = level;
+                _logger.assign(logger);
+                _file.assign(file);
+                _tID = std::this_thread::get_id();
+                _thread = ThreadInfo::Current();
+                _mdc = MDC::Current();
+                _line = line;
+                _payload.clear();
+            }
+
+            // 释放消息持有的线程信息和上下文引用，保留字符串容量
+            void clear() {
+                _thread.reset();
+                _mdc.reset();
+                _payload.clear();
+            }
+
+            time_t getTime_t() const { return Clock::ToTime_t(_ctime); }  //获取时间戳（秒）
+            int64_t getTimeNs() const { return Clock::ToNanoseconds(_ctime); }  //获取时间戳（自1970年以来的纳秒数）
+            const Clock::Timestamp& getTimestamp() const { return _ctime; }  //获取原始时间戳，换算推迟到使用时
             LogLevel::Level getLevel() const { return _level; } //获取日志级别
-            std::string getLogger() const { return _logger; } //获取日志名称
-            static std::thread::id getThreadID() { return std::this_thread::get_id(); } //获取线程ID
-            std::string getFile() const { return _file; } //获取源码文件名
+            const std::string& getLogger() const { return _logger; } //获取日志名称
+            std::thread::id getThreadID() const { return _tID; } //获取线程ID
+            const ThreadInfo::ptr& getThreadInfo() const { return _thread; } //获取生产者线程信息
+            const MDC::ptr& getMDC() const { return _mdc; } //获取MDC快照
+            const std::string& getFile() const { return _file; } //获取源码文件名
             size_t getLine() const { return _line; } //获取源码行号
-            std::string getPayload() const { return _payload; } //获取日志内容
+            const std::string& getPayload() const { return _payload; } //获取日志内容
+            std::string& getPayloadBuffer() { return _payload; } //获取日志内容缓冲区，用于直接写入
 
-            void setTime_t(time_t ctime) { _ctime = ctime; } //设置时间戳
+            void setTime_t(time_t ctime) { _ctime = Clock::Timestamp{static_cast<uint64_t>(ctime) * 1000000000ULL, false}; } //设置时间戳
             void setLevel(LogLevel::Level level) { _level = level; }
             void setLogger(const std::string& logger) { _logger = logger; } //设置日志名称
             void setFile(const std::string& file) { _file = file; } //设置源码文件名
             void setLine(size_t line) { _line = line; } //设置源码行号
             void setPayload(const std::string& payload) { _payload = payload; } //设置日志内容
             void setThreadID(std::thread::id tid) { _tID = tid; } //设置线程ID
+            void setThreadInfo(ThreadInfo::ptr info) { _thread = std::move(info); } //设置线程信息
+            void setMDC(MDC::ptr mdc) { _mdc = std::move(mdc); } //设置MDC快照
 
         protected:
-            time_t _ctime;   //时间戳
+            Clock::Timestamp _ctime;   //时间戳
             LogLevel::Level _level;  //日志级别
             std::string _logger;  //日志名称
             std::string _file;  //源码文件名
             std::thread::id _tID;  //线程ID
+            ThreadInfo::ptr _thread;  //生产者线程信息
+            MDC::ptr _mdc;  //MDC快照
             size_t _line;  //源码行号
             std::string _payload;  //日志内容
 
@@ -0,0 +1,62 @@
+#pragma once
+
+#ifndef __MSG_POOL_H__
+#define __MSG_POOL_H__
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "Message.hpp"
+
+/*
+ * MsgPool是日志消息缓冲池，避免异步日志在生产者线程分配、在消费者线程释放内存。
+ * 缓冲区按批（slab）分配且不再归还系统，缓冲池按峰值积压增长、从不收缩；每个缓冲区内的字符串预留固定容量，
+ * 稳定状态下一条日志不会调用malloc；超过保留上限的大消息走溢出路径，用完后释放多余容量。
+ * 每个生产者线程拥有自己的MsgCache空闲链表：本线程取用时无需同步，
+ * 消费者写完后通过无锁栈把缓冲区归还给所属的生产者。线程退出后其MsgCache由新线程接管。
+ */
+
+namespace log{
+
+    class MsgCache;
+
+    // 消息缓冲区，同时作为异步队列的侵入式链表节点
+    struct MsgBuffer{
+        // 释放器，将缓冲区归还给缓冲池
+        struct Releaser{
+            void operator()(MsgBuffer* buf) const;
+        };
+        using ptr = std::unique_ptr<MsgBuffer, Releaser>;
+
+        MsgBuffer* next = nullptr;  // 空闲链表或队列中的下一个节点
+        MsgCache* owner = nullptr;  // 所属的生产者缓存
+        LogMsg msg;  // 日志消息
+    };
+
+    // 生产者线程的缓冲区缓存
+    class MsgCache{
+        public:
+            MsgBuffer* Acquire();  // 只能由所属线程调用
+            void Push(MsgBuffer* buf);  // 任意线程归还缓冲区
+            void PushLocal(MsgBuffer* buf);  // 所属线程归还缓冲区，无需同步
+
+        private:
+            void AllocateSlab();  // 分配一批新的缓冲区
+
+            MsgBuffer* _free = nullptr;  // 本线程私有的空闲链表
+            std::atomic<MsgBuffer*> _returned{nullptr};  // 其他线程归还的缓冲区（无锁栈）
+    };
+
+    class MsgPool{
+        public:
+            static constexpr size_t kSlabSize = 64;  // 每批分配的缓冲区数量
+            static constexpr size_t kBufferSize = 256;  // 每个字符串预留的容量
+            static constexpr size_t kMaxRetained = 4096;  // 单个缓冲区归还时保留的最大字符串容量，超出部分释放；不限制缓冲区数量
+
+            static MsgBuffer::ptr Acquire();  // 获取一个缓冲区，所属为当前线程
+            static void Release(MsgBuffer* buf);  // 归还缓冲区给所属的生产者
+    };
+}
+
+#endif
@@ -0,0 +1,190 @@
+#pragma once
+
+#ifndef __SCOPE_TIMER_H__
+#define __SCOPE_TIMER_H__
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Clock.hpp"
+#include "Logger.hpp"
+
+/*
+ * LOG_SCOPE_TIMER(logger, "name") 统计所在作用域的耗时，按调用位置汇总到延迟直方图，
+ * 由后台线程定期通过该日志器（正常的Formatter和接收器）为每个调用位置输出一行汇总：
+ *   timer db.query count=1234 p50=12.3us p99=85.0us max=1.20ms
+ * 同一调用位置使用不同的日志器时按日志器分别统计，每个日志器只输出自己的调用。
+ * LOG_SCOPE_TIMER_SLOW(logger, "name", threshold) 另外为耗时达到threshold的单次调用输出一条WARN日志。
+ * 每个线程在每个调用位置、对每个日志器有自己的直方图，记录时只读两次时钟并增加一个桶的计数，不加锁；
+ * 汇报线程读取并清零各线程的计数，因此每行汇总统计的是上一个汇报周期内的调用。
+ * 线程退出后其直方图由使用同一日志器的新线程接管；日志器销毁后其未汇报的计数被丢弃。
+ */
+
+namespace log{
+
+    // 对数线性分桶的延迟直方图（纳秒）：每个2的幂区间再均分为16个桶，相对误差不超过1/16
+    class TimerHistogram{
+        public:
+            static constexpr size_t kSubBits = 4;
+            static constexpr size_t kSubBuckets = size_t(1) << kSubBits;
+            static constexpr size_t kBuckets = (64 - kSubBits + 1) * kSubBuckets;
+
+            static size_t BucketOf(uint64_t ns)  // 数值所在的桶
+            {
+                if (ns < kSubBuckets) {
+                    return static_cast<size_t>(ns);
+                }
+                size_t shift = std::bit_width(ns) - 1 - kSubBits;
+                return (shift + 1) * kSubBuckets + static_cast<size_t>((ns >> shift) - kSubBuckets);
+            }
+
+            static uint64_t UpperBound(size_t index)  // 桶内的最大值
+            {
+                if (index < kSubBuckets) {
+                    return index;
+                }
+                size_t shift = index / kSubBuckets - 1;
+                uint64_t lower = static_cast<uint64_t>(kSubBuckets + index % kSubBuckets) << shift;
+                return lower + ((uint64_t(1) << shift) - 1);
+            }
+
+            void Record(uint64_t ns)  // 记录一次耗时，只由所属线程调用
+            {
+                _buckets[BucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+                uint64_t max = _max.load(std::memory_order_relaxed);
+                while (ns > max && !_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+                }
+            }
+
+        private:
+            friend class TimerSite;
+
+            // 是否属于该日志器：比较控制块，直方图持有weak_ptr，日志器销毁后地址被复用也不会误判
+            template<class L>
+            bool BelongsTo(const L& logger) const
+            {
+                return !_logger.owner_before(logger) && !logger.owner_before(_logger);
+            }
+
+            void Clear()  // 丢弃计数
+            {
+                for (auto& bucket : _buckets) {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+                _max.store(0, std::memory_order_relaxed);
+            }
+
+            std::array<std::atomic<uint64_t>, kBuckets> _buckets{};
+            std::atomic<uint64_t> _max{0};
+            std::atomic<bool> _owned{true};  // 是否有线程在使用，线程退出后可被新线程接管
+            std::weak_ptr<Logger> _logger;  // 汇报使用的日志器，只在持有 TimerSite::_mutex 时修改
+    };
+
+    // 一个调用位置，由 LOG_SCOPE_TIMER 以静态变量的形式定义
+    class TimerSite{
+        public:
+            TimerSite(const char* name, const char* file, size_t line, std::chrono::nanoseconds slow = std::chrono::nanoseconds(0));
+            ~TimerSite();
+            TimerSite(const TimerSite&) = delete;
+            TimerSite& operator=(const TimerSite&) = delete;
+
+            // 当前线程在本调用位置、对该日志器的直方图，第一次使用时创建或接管
+            template<class L>
+            TimerHistogram& Local(const std::shared_ptr<L>& logger)
+            {
+                std::vector<std::vector<TimerHistogram*>>& locals = t_locals.histograms;
+                if (_id < locals.size()) {
+                    for (TimerHistogram* histogram : locals[_id]) {
+                        if (histogram->BelongsTo(logger)) {
+                            return *histogram;
+                        }
+                    }
+                }
+                return attach(logger);
+            }
+
+            void Report();  // 按日志器汇总各线程上一周期的计数，每个日志器输出一行，没有调用时不输出
+
+            const char* GetName() const { return _name; }
+            const char* GetFile() const { return _file; }
+            size_t GetLine() const { return _line; }
+            uint64_t GetSlowThreshold() const { return _slow_ns; }  // 单次输出的阈值（纳秒），0表示不输出
+
+        private:
+            // 线程持有的直方图，线程退出时交还
+            struct ThreadLocals{
+                std::vector<std::vector<TimerHistogram*>> histograms;  // 按调用位置编号索引，每个日志器一个
+                ~ThreadLocals();
+            };
+
+            TimerHistogram& attach(std::weak_ptr<Logger> logger);
+
+            size_t _id;  // 调用位置编号
+            const char* _name;
+            const char* _file;
+            size_t _line;
+            uint64_t _slow_ns;
+            std::mutex _mutex;  // 保护 _histograms 和直方图的日志器
+            std::vector<std::unique_ptr<TimerHistogram>> _histograms;  // 所有线程、所有日志器的直方图
+
+            static inline thread_local ThreadLocals t_locals;
+    };
+
+    // 定期汇报所有调用位置的统计结果，第一个调用位置注册时启动后台线程
+    class TimerReporter{
+        public:
+            static void SetInterval(std::chrono::milliseconds interval);  // 设置汇报周期，默认60秒
+            static void ReportNow();  // 立即汇报一次，例如在程序退出前调用
+    };
+
+    // 统计作用域耗时
+    class ScopeTimer{
+        public:
+            template<class L>
+            ScopeTimer(const std::shared_ptr<L>& logger, TimerSite& site)
+                : _histogram(site.Local(logger)), _site(site), _logger(logger.get()), _start(Clock::MonotonicNow()) {}
+
+            ~ScopeTimer()
+            {
+                int64_t elapsed = Clock::Elapsed(_start, Clock::MonotonicNow());
+                uint64_t ns = elapsed > 0 ? static_cast<uint64_t>(elapsed) : 0;
+                _histogram.Record(ns);
+                if (_site.GetSlowThreshold() > 0 && ns >= _site.GetSlowThreshold()) {
+                    _logger->Warn(_site.GetFile(), _site.GetLine(), "timer ", _site.GetName(), " took ", FormatDuration(ns));
+                }
+            }
+
+            ScopeTimer(const ScopeTimer&) = delete;
+            ScopeTimer& operator=(const ScopeTimer&) = delete;
+
+            static std::string FormatDuration(uint64_t ns);  // 按量级输出为 ns/us/ms/s
+
+        private:
+            TimerHistogram& _histogram;
+            TimerSite& _site;
+            Logger* _logger;
+            Clock::Tick _start;  // 单调计数，系统时间被调整不影响耗时
+    };
+}
+
+#define LOG_SCOPE_TIMER_CONCAT_(a, b) a##b
+#define LOG_SCOPE_TIMER_CONCAT(a, b) LOG_SCOPE_TIMER_CONCAT_(a, b)
+
+// 统计当前作用域的耗时，logger 为 Logger（或其派生类）的 shared_ptr
+#define LOG_SCOPE_TIMER(logger, name) \
+    static ::log::TimerSite LOG_SCOPE_TIMER_CONCAT(_log_timer_site_, __LINE__)(name, __FILE__, __LINE__); \
+    ::log::ScopeTimer LOG_SCOPE_TIMER_CONCAT(_log_scope_timer_, __LINE__)(logger, LOG_SCOPE_TIMER_CONCAT(_log_timer_site_, __LINE__))
+
+// 同上，单次耗时达到 threshold（std::chrono::duration）时另外输出一条WARN日志
+#define LOG_SCOPE_TIMER_SLOW(logger, name, threshold) \
+    static ::log::TimerSite LOG_SCOPE_TIMER_CONCAT(_log_timer_site_, __LINE__)(name, __FILE__, __LINE__, threshold); \
+    ::log::ScopeTimer LOG_SCOPE_TIMER_CONCAT(_log_scope_timer_, __LINE__)(logger, LOG_SCOPE_TIMER_CONCAT(_log_timer_site_, __LINE__))
+
+#endif
@@ -5,12 +5,14 @@
 
 #include <memory>
 #include "LogSink.hpp"
+#include "StaticLogger.hpp"
 
 /*
  * SinkFactory类用于创建日志接收器（Sink）的工厂类。
  * 它提供了一个静态方法createSink，可以根据指定的接收器类型和参数创建对应的日志接收器实例。
  * 通过使用SinkFactory，用户可以方便地创建不同类型的日志接收器，而无需关心具体的实现细节。
  * 例如，可以创建标准输出接收器、文件接收器或按大小轮转的接收器等。
+ * createStaticLogger则把多个接收器按值组合成tuple，创建编译期分发的StaticLogger。
 */
 
 namespace log {
@@ -24,6 +26,12 @@ namespace log {
                 // 创建指定类型的日志接收器
                 return std::make_shared<SinkType>(std::forward<Args>(args)...);
             }
+
+            // 创建编译期组合的日志记录器，每个接收器对应一个构造参数tuple，接收器在logger内部原地构造
+            template<class FormatterType, class... Sinks, typename... SinkArgs>
+            static StaticLogger<FormatterType, Sinks...> createStaticLogger(const std::string& name, LogLevel::Level level, SinkArgs&&... sink_args) {
+                return StaticLogger<FormatterType, Sinks...>(name, level, std::forward<SinkArgs>(sink_args)...);
+            }
     };
 
 }
@@ -0,0 +1,185 @@
+#pragma once
+
+#ifndef __STATIC_FORMATTER_H__
+#define __STATIC_FORMATTER_H__
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "Message.hpp"
+
+/*
+ * StaticFormatter是在编译期解析格式化模式的格式化器，模式作为模板参数传入，
+ * 语法与Formatter相同（%d{...} %p %c %t %N %X{key} %f %l %m %n %T %%）。
+ * 解析结果是编译期常量，格式化时按格式化项逐个展开，没有虚函数调用，也不经过ostream，
+ * 编译器可以把整个格式化过程内联到调用处。模式非法时在编译期报错。
+ * 例如：log::StaticFormatter<"%d{%H:%M:%S}[%p][%c]%T%m%n">
+ */
+
+namespace log{
+
+    // 可以作为模板参数的字符串常量
+    template<size_t N>
+    struct FixedString{
+        char data[N]{};
+        constexpr FixedString(const char (&str)[N]) {
+            for (size_t i = 0; i < N; i++) {
+                data[i] = str[i];
+            }
+        }
+        constexpr size_t size() const { return N - 1; }
+    };
+
+    template<FixedString Pattern>
+    class StaticFormatter{
+        public:
+            // 将日志消息格式化后追加到out
+            void Format(std::string& out, const LogMsg& msg) const {
+                formatItems(out, msg, std::make_index_sequence<kParsed.count>{});
+            }
+
+            // 将日志消息格式化为字符串并返回
+            std::string Format(const LogMsg& msg) const {
+                std::string out;
+                Format(out, msg);
+                return out;
+            }
+
+        private:
+            static constexpr size_t kSize = Pattern.size() + 1;
+
+            // 编译期解析出的格式化项，'o'表示原样输出的文本，文本和参数都保存在text中
+            struct Item{
+                char key = 0;
+                size_t begin = 0;  // 参数（或原始文本）在text中的起始位置
+                size_t len = 0;  // 参数（或原始文本）的长度，text中其后紧跟'\0'
+            };
+
+            struct Parsed{
+                std::array<Item, kSize> items{};
+                size_t count = 0;
+                std::array<char, kSize * 5> text{};  // 足够容纳每个%d的默认时间格式
+                size_t text_len = 0;
+                bool ok = true;
+
+                constexpr size_t append(std::string_view str) {
+                    size_t begin = text_len;
+                    for (char ch : str) {
+                        text[text_len++] = ch;
+                    }
+                    text[text_len++] = '\0';
+                    return begin;
+                }
+                constexpr void push(char key, size_t begin, size_t len) {
+                    items[count++] = Item{key, begin, len};
+                }
+            };
+
+            // 与Formatter::ParsePattern相同的解析规则
+            static constexpr Parsed parse() {
+                Parsed parsed;
+                std::string_view pattern(Pattern.data, Pattern.size());
+                char str[kSize]{};  // 待输出的原始文本
+                size_t str_len = 0;
+                for (size_t i = 0; i < pattern.size(); i++) {
+                    if (pattern[i] != '%') {
+                        str[str_len++] = pattern[i];
+                        continue;
+                    }
+                    if ((i + 1) < pattern.size() && pattern[i + 1] == '%') {
+                        str[str_len++] = '%';
+                        i++;
+                        continue;
+                    }
+                    if (str_len > 0) {
+                        parsed.push('o', parsed.append(std::string_view(str, str_len)), str_len);
+                        str_len = 0;
+                    }
+                    i++;
+                    if (i >= pattern.size()) {
+                        parsed.ok = false;
+                        return parsed;
+                    }
+                    char key = pattern[i];
+                    std::string_view value;
+                    if ((i + 1) < pattern.size() && pattern[i + 1] == '{') {
+                        size_t end_bracket = pattern.find('}', i + 2);
+                        if (end_bracket == std::string_view::npos) {
+                            parsed.ok = false;
+                            return parsed;
+                        }
+                        value = pattern.substr(i + 2, end_bracket - i - 2);
+                        i = end_bracket;
+                    }
+                    if (key == 'd' && value.empty()) {
+                        value = "%H:%M:%S";
+                    }
+                    parsed.push(key, parsed.append(value), value.size());
+                }
+                if (str_len > 0) {
+                    parsed.push('o', parsed.append(std::string_view(str, str_len)), str_len);
+                }
+                return parsed;
+            }
+
+            static constexpr Parsed kParsed = parse();
+            static_assert(kParsed.ok, "Failed to parse log pattern");
+
+            template<size_t... I>
+            static void formatItems(std::string& out, const LogMsg& msg, std::index_sequence<I...>) {
+                (formatItem<I>(out, msg), ...);
+            }
+
+            // 按编译期确定的格式化项输出，if constexpr 只保留对应的分支
+            template<size_t I>
+            static void formatItem(std::string& out, const LogMsg& msg) {
+                constexpr Item item = kParsed.items[I];
+                constexpr std::string_view value(kParsed.text.data() + item.begin, item.len);
+                if constexpr (item.key == 'd') {
+                    out.append(Date::FormatLocal(msg.getTime_t(), value));
+                } else if constexpr (item.key == 'p') {
+                    out.append(LogLevel::ToString(msg.getLevel()));
+                } else if constexpr (item.key == 'c') {
+                    out.append(msg.getLogger());
+                } else if constexpr (item.key == 't') {
+                    if (msg.getThreadInfo()) {
+                        out.append(msg.getThreadInfo()->getTidText());
+                    }
+                } else if constexpr (item.key == 'N') {
+                    if (msg.getThreadInfo()) {
+                        out.append(msg.getThreadInfo()->getName());
+                    }
+                } else if constexpr (item.key == 'X') {
+                    if (!msg.getMDC()) {
+                        return;
+                    }
+                    if constexpr (value.empty()) {
+                        out.append(msg.getMDC()->getText());
+                    } else if (const std::string* mdc_value = msg.getMDC()->Find(value)) {
+                        out.append(*mdc_value);
+                    }
+                } else if constexpr (item.key == 'f') {
+                    out.append(msg.getFile());
+                } else if constexpr (item.key == 'l') {
+                    char buffer[24];
+                    auto result = std::to_chars(buffer, buffer + sizeof(buffer), msg.getLine());
+                    out.append(buffer, result.ptr);
+                } else if constexpr (item.key == 'm') {
+                    out.append(msg.getPayload());
+                } else if constexpr (item.key == 'n') {
+                    out.push_back('\n');
+                } else if constexpr (item.key == 'T') {
+                    out.push_back('\t');
+                } else {
+                    out.append(value);  // 原始文本以及未知的格式化项
+                }
+            }
+    };
+}
+
+#endif
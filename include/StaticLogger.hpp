@@ -0,0 +1,126 @@
+#pragma once
+
+#ifndef __STATIC_LOGGER_H__
+#define __STATIC_LOGGER_H__
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "LogCalls.hpp"
+#include "Level.hpp"
+#include "LogSink.hpp"
+#include "MsgPool.hpp"
+#include "StaticFormatter.hpp"
+
+/*
+ * StaticLogger是格式化器和接收器都在编译期确定的日志记录器。
+ * 格式化器（通常是StaticFormatter）按值保存，接收器以std::tuple按值组合，
+ * 写入时通过限定名直接调用具体接收器的LogtoSink，没有虚函数、shared_ptr和接收器列表遍历，
+ * 编译器可以把从调用处到接收器缓冲区的整条路径内联。
+ * 调用方式与Logger相同，接收器的级别阈值、过滤器和单独的格式化器同样生效。
+ * 例如：
+ *   log::StaticLogger<log::StaticFormatter<"[%p][%c]%T%m%n">, log::StdOutSink, log::FileSink>
+ *       logger("app", log::LogLevel::Level::INFO, std::make_tuple(), std::make_tuple("./app.log"));
+ */
+
+namespace log{
+
+    // 在tuple中原地构造接收器，接收器不需要支持拷贝或移动
+    template<class SinkType>
+    struct SinkSlot{
+        SinkType sink;
+
+        SinkSlot() = default;
+        template<class Tuple>
+        explicit SinkSlot(Tuple&& args) : sink(std::make_from_tuple<SinkType>(std::forward<Tuple>(args))) {}
+
+        void Write(const char* data, size_t len) {
+            sink.SinkType::LogtoSink(data, len);  // 限定名调用，编译期确定目标函数
+        }
+    };
+
+    template<class FormatterType, class... Sinks>
+    class StaticLogger : public LevelListener, public LogCalls<StaticLogger<FormatterType, Sinks...>>{
+        public:
+            // 每个接收器对应一个构造参数tuple；不传参数时默认构造所有接收器
+            template<class... SinkArgs>
+            explicit StaticLogger(const std::string& name = "root", LogLevel::Level level = LogLevel::Level::UNKNOWN, SinkArgs&&... sink_args)
+                : _logger(name), _level(level), _sinks(std::forward<SinkArgs>(sink_args)...) {
+                static_assert(sizeof...(SinkArgs) == 0 || sizeof...(SinkArgs) == sizeof...(Sinks),
+                              "StaticLogger needs one constructor argument tuple per sink");
+                std::apply([this](auto&... slots) { (slots.sink.AddListener(this), ...); }, _sinks);  // 接收器与日志器同生命周期，无需注销
+                RefreshLevel();
+            }
+
+            StaticLogger(const StaticLogger&) = delete;
+            StaticLogger& operator=(const StaticLogger&) = delete;
+
+            // 获取第I个接收器，用于设置级别、过滤器等
+            template<size_t I>
+            auto& GetSink() { return std::get<I>(_sinks).sink; }
+
+            // 重新计算有效级别阈值，接收器的级别修改时自动调用
+            void RefreshLevel() override {
+                std::lock_guard<std::mutex> lock(_mutex);
+                LogLevel::Level sink_level = LogLevel::Level::OFF;
+                std::apply([&](auto&... slots) {
+                    ((sink_level = slots.sink.GetLevel() < sink_level ? slots.sink.GetLevel() : sink_level), ...);
+                }, _sinks);
+                _threshold.store(sink_level > _level ? sink_level : _level, std::memory_order_relaxed);
+            }
+
+        private:
+            // LogCalls 使用的钩子
+            friend class LogCalls<StaticLogger>;
+            bool levelEnabled(LogLevel::Level level) const {
+                return level >= _threshold.load(std::memory_order_relaxed);  // 低于日志器级别或所有接收器的级别，则不记录日志
+            }
+            const std::string& loggerName() const { return _logger; }
+            void dispatchLog(MsgBuffer::ptr buf) { dispatch(buf->msg); }
+
+            // 写入所有接收器
+            void dispatch(const LogMsg& msg) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                bool formatted = false;  // 编译期格式化器的结果只生成一次，由所有接收器共享
+                std::apply([&](auto&... slots) {
+                    (writeToSink(slots, msg, formatted), ...);
+                }, _sinks);
+            }
+
+            template<class Slot>
+            void writeToSink(Slot& slot, const LogMsg& msg, bool& formatted) {
+                if (!slot.sink.ShouldLog(msg)) {
+                    return;
+                }
+                if (Formatter::ptr sink_formatter = slot.sink.GetFormatter()) {
+                    // 接收器单独设置了运行期格式化器
+                    _sink_formatted.clear();
+                    sink_formatter->Format(_sink_formatted, msg);
+                    slot.Write(_sink_formatted.data(), _sink_formatted.size());
+                    return;
+                }
+                if (!formatted) {
+                    _formatted.clear();
+                    _formatter.Format(_formatted, msg);
+                    formatted = true;
+                }
+                slot.Write(_formatted.data(), _formatted.size());
+            }
+
+            std::mutex _mutex;  // 互斥锁，保护接收器和格式化缓冲区
+            std::string _logger;  // 日志记录器名称
+            LogLevel::Level _level;  // 日志级别
+            std::atomic<LogLevel::Level> _threshold{LogLevel::Level::UNKNOWN};  // 有效级别阈值
+            FormatterType _formatter;  // 编译期格式化器
+            std::tuple<SinkSlot<Sinks>...> _sinks;  // 编译期确定的接收器
+            std::string _formatted;  // 格式化结果缓冲区，复用容量
+            std::string _sink_formatted;  // 接收器自带格式化器的结果缓冲区
+    };
+}
+
+#endif
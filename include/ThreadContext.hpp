@@ -0,0 +1,86 @@
+#pragma once
+
+#ifndef __THREAD_CONTEXT_H__
+#define __THREAD_CONTEXT_H__
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+
+/*
+ * ThreadInfo类缓存当前线程的内核线程号(tid)、线程名以及它们格式化后的文本。
+ * 每个线程只在第一次记录日志（或调用SetName改名）时生成一次，之后LogMsg只需拷贝一个指针，
+ * 格式化时直接输出缓存好的文本，不再每行通过ostream输出std::thread::id。
+ *
+ * MDC（Mapped Diagnostic Context）为每个线程维护一组键值对（如请求ID、租户等），
+ * 可以通过格式化模式中的 %X{key}（单个键）和 %X（全部键值对）输出。
+ * MDC采用写时复制：Put/Remove时生成新的只读快照，LogMsg只持有快照指针，
+ * 不会在每条日志上重新拼接字符串。
+ */
+
+namespace log{
+
+    // 线程身份信息，创建后只读，多个日志消息共享同一份
+    class ThreadInfo{
+        public:
+            using ptr = std::shared_ptr<const ThreadInfo>;
+            ThreadInfo(pid_t tid, std::string name);
+
+            static const ptr& Current();  // 获取当前线程的线程信息，每个线程只创建一次
+            static void SetName(const std::string& name);  // 设置当前线程名称（同时设置系统线程名）并刷新缓存
+
+            pid_t getTid() const { return _tid; }  // 获取内核线程号
+            const std::string& getTidText() const { return _tid_text; }  // 获取格式化好的线程号文本
+            const std::string& getName() const { return _name; }  // 获取线程名
+
+        private:
+            pid_t _tid;  // 内核线程号
+            std::string _tid_text;  // 线程号文本缓存
+            std::string _name;  // 线程名
+    };
+
+    // 线程局部的诊断上下文
+    class MDC{
+        public:
+            using Map = std::map<std::string, std::string, std::less<>>;
+
+            // MDC的只读快照，创建时预先拼接好 %X 使用的完整文本
+            class Snapshot{
+                public:
+                    explicit Snapshot(Map values);
+                    const std::string* Find(std::string_view key) const;  // 查找键，不存在时返回nullptr
+                    const std::string& getText() const { return _text; }  // 获取 "k1=v1 k2=v2" 形式的文本
+                    const Map& getValues() const { return _values; }
+                private:
+                    Map _values;
+                    std::string _text;
+            };
+            using ptr = std::shared_ptr<const Snapshot>;
+
+            static void Put(const std::string& key, const std::string& value);  // 设置当前线程的键值
+            static void Remove(const std::string& key);  // 删除当前线程的键
+            static void Clear();  // 清空当前线程的上下文
+            static std::string Get(const std::string& key);  // 获取当前线程的键值，不存在时返回空串
+            static const ptr& Current();  // 获取当前线程的快照，上下文为空时为nullptr
+
+        private:
+            static void Update(Map values);  // 用新的键值集合替换当前线程的快照
+    };
+
+    // MDC作用域守卫，构造时设置键值，析构时恢复原值
+    class MDCGuard{
+        public:
+            MDCGuard(const std::string& key, const std::string& value);
+            ~MDCGuard();
+            MDCGuard(const MDCGuard&) = delete;
+            MDCGuard& operator=(const MDCGuard&) = delete;
+        private:
+            std::string _key;
+            std::string _old_value;
+            bool _had_old;
+    };
+}
+
+#endif
@@ -6,7 +6,10 @@
 #include <ctime>
 
 #include <sys/stat.h>
+#include <ostream>
+#include <streambuf>
 #include <string>
+#include <string_view>
 
 /*
  * 提供了日期和文件操作的实用工具类。
@@ -15,9 +18,11 @@
  * File类用于检查文件是否存在、获取文件路径、创建目录等操作。
  *  Date::Now() 返回当前时间的时间戳（time_t类型）。
  *  Date::GetTimeSet() 返回当前时间的 struct tm 结构。
+ *  Date::FormatLocal(ts, format) 按 strftime 格式输出本地时间，每个线程按秒缓存结果。
  *  File::IsFileExist(const std::string& file_path) 检查指定文件是否存在。
  *  File::GetPath(const std::string & file_path) 获取指定文件的所在目录路径。
  *  File::CreateDir(const std::string & file_path) 创建指定路径的目录。
+ *  AppendStream 是直接追加到已有 std::string 的输出流，复用字符串容量，避免 stringstream 每次分配内存。
  *
  */
 
@@ -39,6 +44,43 @@ namespace log{
                 localtime_r(&time_stamp, &t);   // 将时间戳转换为本地时间
                 return t; // 返回本地时间的 struct tm 结构
             }
+
+            // 按 strftime 格式输出本地时间。localtime_r 会获取glibc的时区锁，多个格式化线程同时调用时互相阻塞，
+            // 因此每个线程缓存最近几种格式在当前这一秒的结果，同一秒内的后续调用直接返回缓存
+            static std::string_view FormatLocal(time_t ts, std::string_view format)
+            {
+                struct Entry{
+                    time_t ts = -1;
+                    std::string format;
+                    char text[64] = {0};
+                    size_t len = 0;
+                };
+                static thread_local Entry cache[4];
+                static thread_local size_t next = 0;  // 下一个替换的缓存项
+
+                for (Entry& entry : cache) {
+                    if (entry.ts == ts && entry.format == format) {
+                        return std::string_view(entry.text, entry.len);
+                    }
+                }
+                Entry* entry = nullptr;
+                for (Entry& candidate : cache) {
+                    if (candidate.format == format) {
+                        entry = &candidate;  // 同一格式只占用一项
+                        break;
+                    }
+                }
+                if (!entry) {
+                    entry = &cache[next];
+                    next = (next + 1) % (sizeof(cache) / sizeof(cache[0]));
+                    entry->format.assign(format);
+                }
+                struct tm t{};
+                localtime_r(&ts, &t);
+                entry->len = strftime(entry->text, sizeof(entry->text), entry->format.c_str(), &t);
+                entry->ts = ts;
+                return std::string_view(entry->text, entry->len);
+            }
     };
 
     class File{
@@ -85,6 +127,35 @@ namespace log{
 
     };
 
+    // 直接追加写入目标字符串的输出流
+    class AppendStream : public std::ostream{
+        public:
+            explicit AppendStream(std::string& out) : std::ostream(nullptr), _buf(out) {
+                rdbuf(&_buf);
+            }
+
+        private:
+            class StringBuf : public std::streambuf{
+                public:
+                    explicit StringBuf(std::string& out) : _out(out) {}
+                protected:
+                    int_type overflow(int_type ch) override {
+                        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                            _out.push_back(traits_type::to_char_type(ch));
+                        }
+                        return traits_type::not_eof(ch);
+                    }
+                    std::streamsize xsputn(const char* s, std::streamsize n) override {
+                        _out.append(s, static_cast<size_t>(n));
+                        return n;
+                    }
+                private:
+                    std::string& _out;  // 目标字符串
+            };
+
+            StringBuf _buf;
+    };
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "../include/Clock.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace log{
+
+    namespace {
+        // 一段校准结果：wall_ns = base_ns + (tick - base_tick) * ns_per_tick
+        // 槽位会被复用，读者用 version 做顺序锁检查：奇数表示正在写入，前后两次读取不同则重试
+        struct Segment{
+            std::atomic<uint64_t> version{0};
+            std::atomic<uint64_t> index{0};  // 该槽位当前保存的是第几段
+            std::atomic<uint64_t> base_tick{0};
+            std::atomic<int64_t> base_ns{0};
+            std::atomic<double> ns_per_tick{1.0};
+        };
+
+        // 从槽位读出的一致快照
+        struct SegmentValue{
+            uint64_t index;
+            uint64_t base_tick;
+            int64_t base_ns;
+            double ns_per_tick;
+        };
+
+        constexpr size_t kSegments = 16;  // 保留的校准段数
+        Segment g_segments[kSegments];
+        std::atomic<uint64_t> g_segment_count{0};  // 已发布的校准段总数
+        std::atomic<double> g_measured_ns_per_tick{1.0};  // 最近一次实测的计数器频率，不含追赶修正
+
+        SegmentValue Load(const Segment& segment){
+            while (true) {
+                uint64_t version = segment.version.load(std::memory_order_acquire);
+                if (version & 1) {
+                    continue;  // 正在写入
+                }
+                SegmentValue value{
+                    segment.index.load(std::memory_order_relaxed),
+                    segment.base_tick.load(std::memory_order_relaxed),
+                    segment.base_ns.load(std::memory_order_relaxed),
+                    segment.ns_per_tick.load(std::memory_order_relaxed)};
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (segment.version.load(std::memory_order_relaxed) == version) {
+                    return value;
+                }
+            }
+        }
+
+        void Store(Segment& segment, const SegmentValue& value){
+            uint64_t version = segment.version.load(std::memory_order_relaxed);
+            segment.version.store(version + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            segment.index.store(value.index, std::memory_order_relaxed);
+            segment.base_tick.store(value.base_tick, std::memory_order_relaxed);
+            segment.base_ns.store(value.base_ns, std::memory_order_relaxed);
+            segment.ns_per_tick.store(value.ns_per_tick, std::memory_order_relaxed);
+            segment.version.store(version + 2, std::memory_order_release);
+        }
+
+        int64_t Convert(const SegmentValue& segment, uint64_t tick){
+            double delta = tick >= segment.base_tick
+                ? static_cast<double>(tick - segment.base_tick)
+                : -static_cast<double>(segment.base_tick - tick);
+            return segment.base_ns + static_cast<int64_t>(delta * segment.ns_per_tick);
+        }
+
+        // 是否支持不变TSC（频率不随CPU调频和休眠变化）
+        bool HasInvariantTSC(){
+#if defined(__x86_64__) || defined(__i386__)
+            unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+            if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+                return (edx & (1u << 8)) != 0;
+            }
+#endif
+            return false;
+        }
+    }
+
+    // 后台校准线程
+    class ClockCalibrator{
+        public:
+            static ClockCalibrator& Instance(){
+                static ClockCalibrator calibrator;
+                return calibrator;
+            }
+
+            ~ClockCalibrator(){
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stop = true;
+                }
+                _cond_var.notify_all();
+                if (_thread.joinable()) {
+                    _thread.join();
+                }
+            }
+
+            void Start(std::chrono::milliseconds interval){
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_thread.joinable()) {
+                    return;  // 已经启动
+                }
+                _interval = interval;
+                _counter = HasInvariantTSC() ? Clock::Source::TSC : Clock::Source::Steady;
+
+                // 初始校准：间隔一小段时间取两次样本计算计数器频率
+                Sample first = TakeSample();
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                _last = TakeSample();
+                double ns_per_tick = Frequency(first, _last);
+                if (ns_per_tick <= 0) {
+                    ns_per_tick = 1.0;  // 计数器没有前进，无法测量
+                }
+                Publish(_last.tick, static_cast<int64_t>(_last.wall_ns), ns_per_tick);
+                _ns_per_tick = ns_per_tick;
+                g_measured_ns_per_tick.store(ns_per_tick, std::memory_order_relaxed);
+
+                Clock::_source.store(_counter, std::memory_order_relaxed);
+                _thread = std::thread(&ClockCalibrator::Run, this);
+            }
+
+            static int64_t ToNanoseconds(uint64_t tick){
+                while (true) {
+                    uint64_t count = g_segment_count.load(std::memory_order_acquire);
+                    if (count == 0) {
+                        return 0;
+                    }
+                    // 按计数值选择所在的校准段，同一计数值总是得到同一结果
+                    uint64_t oldest = count > kSegments - 1 ? count - (kSegments - 1) : 0;
+                    for (uint64_t i = count; i-- > oldest; ) {
+                        SegmentValue segment = Load(g_segments[i % kSegments]);
+                        if (segment.index != i) {
+                            break;  // 槽位已被更新的校准段复用，重新读取段数
+                        }
+                        if (tick >= segment.base_tick || i == oldest) {
+                            return Convert(segment, tick);
+                        }
+                    }
+                }
+            }
+
+        private:
+            // 频率用不受NTP调整影响的 CLOCK_MONOTONIC_RAW 测量，系统时间只用于确定墙上时间的偏移
+            struct Sample{
+                uint64_t tick = 0;
+                uint64_t wall_ns = 0;
+                uint64_t raw_ns = 0;
+            };
+
+            ClockCalibrator() = default;
+
+            // 读取一对计数器和系统时间，取多次中读取间隔最短的一次以减小误差
+            Sample TakeSample() const{
+                Sample best;
+                uint64_t best_gap = UINT64_MAX;
+                for (int i = 0; i < 5; i++) {
+                    uint64_t t0 = Clock::ReadCounter(_counter);
+                    uint64_t wall = Clock::SystemNanoseconds();
+                    uint64_t raw = RawNanoseconds();
+                    uint64_t t1 = Clock::ReadCounter(_counter);
+                    if (t1 - t0 < best_gap) {
+                        best_gap = t1 - t0;
+                        best.tick = t0 + (t1 - t0) / 2;
+                        best.wall_ns = wall;
+                        best.raw_ns = raw;
+                    }
+                }
+                return best;
+            }
+
+            static uint64_t RawNanoseconds(){
+                struct timespec ts{};
+                clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+                return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+            }
+
+            // 两次样本之间的计数器频率（纳秒/计数），无法测量时返回0
+            static double Frequency(const Sample& from, const Sample& to){
+                if (to.tick <= from.tick || to.raw_ns <= from.raw_ns) {
+                    return 0;
+                }
+                return static_cast<double>(to.raw_ns - from.raw_ns) / static_cast<double>(to.tick - from.tick);
+            }
+
+            // 发布新的校准段，写入最旧的槽位
+            static void Publish(uint64_t base_tick, int64_t base_ns, double ns_per_tick){
+                uint64_t count = g_segment_count.load(std::memory_order_relaxed);
+                Store(g_segments[count % kSegments], SegmentValue{count, base_tick, base_ns, ns_per_tick});
+                g_segment_count.store(count + 1, std::memory_order_release);
+            }
+
+            void Run(){
+                std::unique_lock<std::mutex> lock(_mutex);
+                while (!_cond_var.wait_for(lock, _interval, [this]{ return _stop; })) {
+                    Sample sample = TakeSample();
+                    if (sample.tick <= _last.tick) {
+                        continue;
+                    }
+                    // 新段从当前换算值开始，与上一段相接；斜率在实测频率上修正偏差，使其在一个校准间隔内追上系统时间
+                    int64_t current = ToNanoseconds(sample.tick);
+                    double measured = Frequency(_last, sample);
+                    if (measured <= 0) {
+                        measured = _ns_per_tick;  // 无法测量，沿用上次的频率
+                    }
+                    double interval_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(_interval).count());
+                    double factor = (static_cast<double>(sample.wall_ns) + interval_ns - static_cast<double>(current)) / interval_ns;
+                    factor = factor < 0.5 ? 0.5 : (factor > 1.5 ? 1.5 : factor);  // 限制修正幅度，斜率始终为正
+                    Publish(sample.tick, current, measured * factor);
+                    _ns_per_tick = measured;
+                    g_measured_ns_per_tick.store(measured, std::memory_order_relaxed);
+                    _last = sample;
+                }
+            }
+
+            std::mutex _mutex;
+            std::condition_variable _cond_var;
+            std::thread _thread;
+            bool _stop = false;
+            std::chrono::milliseconds _interval{1000};
+            Clock::Source _counter = Clock::Source::Steady;  // 实际使用的计数器
+            Sample _last;  // 上一次校准的样本
+            double _ns_per_tick = 1.0;  // 上一次实测的频率
+    };
+
+    int64_t Clock::ToNanoseconds(const Timestamp& ts){
+        if (!ts.tsc) {
+            return static_cast<int64_t>(ts.value);
+        }
+        return ClockCalibrator::ToNanoseconds(ts.value);
+    }
+
+    int64_t Clock::Elapsed(const Tick& start, const Tick& end){
+        if (start.tsc != end.tsc) {
+            return 0;  // 两次读取的计数器不同，无法比较
+        }
+        int64_t ticks = static_cast<int64_t>(end.value - start.value);
+        if (!start.tsc) {
+            return ticks;
+        }
+        return static_cast<int64_t>(static_cast<double>(ticks) * g_measured_ns_per_tick.load(std::memory_order_relaxed));
+    }
+
+    void Clock::UseTSC(std::chrono::milliseconds interval){
+        ClockCalibrator::Instance().Start(interval);
+    }
+}
@@ -8,12 +8,7 @@ namespace log {
 
     // 格式化日志消息，将时间戳转换为指定格式并输出到流中
     void TimeFormatItem::Format(std::ostream& out, const LogMsg& msg) {
-        time_t ts = msg.getTime_t();  // 获取日志消息的时间戳
-        struct tm t{};
-        char buffer[64] = {0};
-        localtime_r(&ts, &t);  // 将时间戳转换为本地时间
-        strftime(buffer, sizeof(buffer), "%H:%M:%S", &t);
-        out << buffer;  // 将格式化后的时间输出到流中
+        out << Date::FormatLocal(msg.getTime_t(), _time);  // 按指定的时间格式输出本地时间，同一秒内复用缓存
     }
 
     // 日志级别格式化子类
@@ -28,7 +23,36 @@ namespace log {
 
     // 线程ID格式化子类
     void ThreadFormatItem::Format(std::ostream& out, const LogMsg& msg){
-        out << log::LogMsg::getThreadID();  // 输出线程ID
+        const auto& info = msg.getThreadInfo();
+        if (info) {
+            out << info->getTidText();  // 输出生产者线程号（缓存好的文本）
+        }
+    }
+
+    // 线程名格式化子类
+    void ThreadNameFormatItem::Format(std::ostream& out, const LogMsg& msg){
+        const auto& info = msg.getThreadInfo();
+        if (info) {
+            out << info->getName();  // 输出生产者线程名
+        }
+    }
+
+    // 构造函数，接受要输出的MDC键
+    MDCFormatItem::MDCFormatItem(std::string key) : _key(std::move(key)) {}
+
+    // MDC格式化子类
+    void MDCFormatItem::Format(std::ostream& out, const LogMsg& msg){
+        const auto& mdc = msg.getMDC();
+        if (!mdc) {
+            return;  // 没有上下文时不输出
+        }
+        if (_key.empty()) {
+            out << mdc->getText();  // 输出全部键值对
+            return;
+        }
+        if (const std::string* value = mdc->Find(_key)) {
+            out << *value;  // 输出指定键的值
+        }
     }
 
     // 文件名格式化子类
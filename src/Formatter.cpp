@@ -28,6 +28,12 @@ namespace log{
         return ssm.str(); // 返回格式化后的字符串
     }
 
+    // Format方法，将日志消息格式化后追加到字符串中，不额外分配内存
+    void Formatter::Format(std::string& out, const LogMsg& msg) const{
+        AppendStream stream(out);
+        Format(stream, msg);
+    }
+
     // 解析日志格式化模式字符串，将其转换为对应的格式化项
     bool Formatter::ParsePattern(){
         std::string str;  // 用于存储键
@@ -83,6 +89,12 @@ namespace log{
         if (key == "t") {
             return std::make_shared<ThreadFormatItem>();
         }
+        if (key == "N") {
+            return std::make_shared<ThreadNameFormatItem>();
+        }
+        if (key == "X") {
+            return std::make_shared<MDCFormatItem>(value);
+        }
         if (key == "f") {
             return std::make_shared<FileFormatItem>();
         }
@@ -0,0 +1,270 @@
+#include "../include/LogExecutor.hpp"
+#include "../include/AsyncLogger.hpp"
+
+#include <functional>
+
+namespace log{
+
+    LogExecutor::LogExecutor(size_t threads, AsyncOptions options) : _options(options) {
+        if (threads == 0) {
+            threads = 1;
+        }
+        try {
+            for (size_t i = 0; i < threads; i++) {
+                _threads.emplace_back(&LogExecutor::workerLoop, this);  // 启动工作线程
+                AsyncOptions thread_options = _options;
+                if (thread_options.cpu >= 0) {
+                    thread_options.cpu += static_cast<int>(i);  // 第i个线程绑定到 cpu + i
+                }
+                ApplyThreadOptions(_threads.back(), thread_options);
+            }
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    LogExecutor::~LogExecutor(){
+        stop();
+    }
+
+    void LogExecutor::stop(){
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _running = false;
+        }
+        _cond_var.notify_all();
+        for (auto& thread : _threads) {
+            if (thread.joinable()) {
+                thread.join();  // 等待工作线程结束
+            }
+        }
+    }
+
+    void LogExecutor::Schedule(AsyncLogger* logger){
+        bool wake;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            logger->_ready_next = nullptr;
+            if (_ready_tail) {
+                _ready_tail->_ready_next = logger;
+            } else {
+                _ready_head.store(logger, std::memory_order_release);
+            }
+            _ready_tail = logger;
+            wake = _parked > 0;
+        }
+        if (wake) {
+            _cond_var.notify_one();  // 只有工作线程休眠时才需要唤醒，避免每条日志一次系统调用
+        }
+    }
+
+    size_t LogExecutor::claim(AsyncLogger** loggers, size_t max){
+        std::unique_lock<std::mutex> lock(_mutex);
+        size_t count = 0;
+        AsyncLogger* logger = _ready_head.load(std::memory_order_relaxed);
+        while (logger && count < max) {
+            loggers[count++] = logger;
+            logger = logger->_ready_next;
+        }
+        _ready_head.store(logger, std::memory_order_relaxed);
+        if (!logger) {
+            _ready_tail = nullptr;
+        }
+        return count;
+    }
+
+    bool LogExecutor::waitForWork(){
+        size_t spins = 0;
+        while (true) {
+            if (_ready_head.load(std::memory_order_acquire) != nullptr) {
+                return true;
+            }
+            if (!_running) {
+                std::unique_lock<std::mutex> lock(_mutex);
+                return _ready_head.load(std::memory_order_relaxed) != nullptr;  // 停止前处理完剩余的日志
+            }
+            switch (_options.wait) {
+                case AsyncOptions::WaitStrategy::BusySpin:
+                    CpuRelax();
+                    break;
+                case AsyncOptions::WaitStrategy::SpinYield:
+                    if (spins++ < _options.spin_count) {
+                        CpuRelax();
+                    } else {
+                        std::this_thread::yield();
+                    }
+                    break;
+                case AsyncOptions::WaitStrategy::SpinPark:
+                    if (spins++ < _options.spin_count) {
+                        CpuRelax();
+                    } else {
+                        park();
+                        spins = 0;
+                    }
+                    break;
+                case AsyncOptions::WaitStrategy::TimedPoll:
+                    std::this_thread::sleep_for(_options.poll_interval);
+                    break;
+            }
+        }
+    }
+
+    void LogExecutor::park(){
+        std::unique_lock<std::mutex> lock(_mutex);
+        _parked++;  // 与入队在同一把锁下修改，Schedule据此决定是否唤醒
+        _cond_var.wait(lock, [this]{
+            return _ready_head.load(std::memory_order_relaxed) != nullptr || !_running;
+        });
+        _parked--;
+    }
+
+    std::mutex& LogExecutor::sinkLock(const LogSink* sink){
+        return _sink_locks[std::hash<const LogSink*>{}(sink) % _sink_locks.size()];
+    }
+
+    void LogExecutor::workerLoop(){
+        std::vector<SinkBatch> batches;  // 本线程的合并缓冲区，跨轮次复用容量
+        FormatScratch scratch;  // 并行格式化模式使用的私有数据
+        AsyncLogger* loggers[kLoggersPerRound];
+        bool ordered = _options.format_threads > 1;
+        while (waitForWork()) {
+            if (ordered) {
+                // 并行格式化模式：每次只取一个日志器，取出一批后它立即可以被其他工作线程处理
+                if (claim(loggers, 1) == 1) {
+                    processOrdered(loggers[0], scratch);
+                }
+                continue;
+            }
+
+            size_t count = claim(loggers, kLoggersPerRound);
+            size_t used = 0;  // 本轮使用的合并缓冲区数量
+
+            // 1. 依次格式化每个日志器的一批日志，按接收器合并
+            for (size_t i = 0; i < count; i++) {
+                AsyncLogger* logger = loggers[i];
+                uint64_t ticket;
+                bool reschedule;
+                MsgBuffer* node = logger->takeBatch(_options.batch_size, ticket, reschedule);  // 单线程模式下 reschedule 总为false
+                std::unique_lock<std::mutex> sink_lock(logger->_mutex);  // 与 AddSink 互斥
+                while (node) {
+                    MsgBuffer::ptr buf(node);
+                    node = node->next;
+                    logger->formatForSinks(buf->msg, [&](LogSink& sink, const std::string& formatted_msg) {
+                        size_t j = 0;
+                        while (j < used && batches[j].sink != &sink) {
+                            j++;
+                        }
+                        if (j == used) {
+                            if (used == batches.size()) {
+                                batches.emplace_back();
+                            }
+                            batches[used].sink = &sink;
+                            batches[used].data.clear();
+                            used++;
+                        }
+                        batches[j].data.append(formatted_msg);
+                    });  // 写完后缓冲区归还给生产者
+                }
+            }
+
+            // 2. 每个接收器一次写入本轮合并的全部日志
+            for (size_t j = 0; j < used; j++) {
+                std::lock_guard<std::mutex> lock(sinkLock(batches[j].sink));
+                batches[j].sink->LogtoSink(batches[j].data.data(), batches[j].data.size());
+            }
+
+            // 3. 仍有日志的日志器重新排到就绪队列尾部，保证公平
+            for (size_t i = 0; i < count; i++) {
+                if (loggers[i]->finishBatch()) {
+                    Schedule(loggers[i]);
+                }
+            }
+        }
+    }
+
+    void LogExecutor::processOrdered(AsyncLogger* logger, FormatScratch& scratch){
+        uint64_t ticket;
+        bool reschedule;
+        MsgBuffer* node = logger->takeBatch(_options.batch_size, ticket, reschedule);
+        if (reschedule) {
+            Schedule(logger);  // 后续批次交给其他工作线程同时格式化
+        }
+
+        ReorderBuffer& reorder = logger->_reorder;
+        OrderedBatch* batch;
+        {
+            std::lock_guard<std::mutex> lock(reorder.mutex);
+            if (!reorder.free) {
+                reorder.storage.push_back(std::make_unique<OrderedBatch>());  // 批次数不超过 format_threads，稳定后不再分配
+                reorder.free = reorder.storage.back().get();
+            }
+            batch = reorder.free;
+            reorder.free = batch->next;
+        }
+        {
+            std::lock_guard<std::mutex> lock(logger->_mutex);  // 只在复制接收器列表时与 AddSink 互斥，格式化不持有锁
+            scratch.sinks.assign(logger->_sinks.begin(), logger->_sinks.end());
+        }
+
+        batch->seq = ticket;
+        batch->used = 0;
+        while (node) {
+            MsgBuffer::ptr buf(node);
+            node = node->next;
+            logger->formatForSinks(scratch.sinks, scratch.cache, buf->msg, [&](LogSink& sink, const std::string& formatted_msg) {
+                size_t j = 0;
+                while (j < batch->used && batch->sinks[j].sink != &sink) {
+                    j++;
+                }
+                if (j == batch->used) {
+                    if (batch->used == batch->sinks.size()) {
+                        batch->sinks.emplace_back();
+                    }
+                    batch->sinks[j].sink = &sink;
+                    batch->sinks[j].data.clear();
+                    batch->used++;
+                }
+                batch->sinks[j].data.append(formatted_msg);
+            });
+        }
+        scratch.sinks.clear();  // 不延长接收器的生命周期
+
+        size_t emitted = emitOrdered(reorder, batch);
+        if (emitted > 0 && logger->finishBatch(emitted)) {
+            Schedule(logger);
+        }
+    }
+
+    size_t LogExecutor::emitOrdered(ReorderBuffer& reorder, OrderedBatch* batch){
+        std::unique_lock<std::mutex> lock(reorder.mutex);
+        OrderedBatch** pos = &reorder.pending;  // 按序号插入等待队列
+        while (*pos && (*pos)->seq < batch->seq) {
+            pos = &(*pos)->next;
+        }
+        batch->next = *pos;
+        *pos = batch;
+        if (reorder.emitting) {
+            return 0;  // 正在写入的线程会接着写出本批次
+        }
+
+        reorder.emitting = true;
+        size_t emitted = 0;
+        while (reorder.pending && reorder.pending->seq == reorder.next_seq) {
+            OrderedBatch* ready = reorder.pending;
+            reorder.pending = ready->next;
+            lock.unlock();
+            for (size_t j = 0; j < ready->used; j++) {
+                std::lock_guard<std::mutex> sink_lock(sinkLock(ready->sinks[j].sink));
+                ready->sinks[j].sink->LogtoSink(ready->sinks[j].data.data(), ready->sinks[j].data.size());
+            }
+            lock.lock();
+            reorder.next_seq = ready->seq + 1;
+            ready->next = reorder.free;
+            reorder.free = ready;
+            emitted++;
+        }
+        reorder.emitting = false;
+        return emitted;
+    }
+}
@@ -1,8 +1,31 @@
 #include "../include/LogSink.hpp"
+#include <cerrno>
+#include <cstring>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 namespace log{
 
+    LogFilter::LogFilter(Type type, std::string pattern) : _type(type), _pattern(std::move(pattern)) {}
+
+    bool LogFilter::Match(const LogMsg& msg) const{
+        if (_type == Type::LoggerPrefix) {
+            return msg.getLogger().compare(0, _pattern.size(), _pattern) == 0;  // 名称前缀匹配
+        }
+        const std::string& file = msg.getFile();
+        if (file.size() < _pattern.size() || file.compare(file.size() - _pattern.size(), _pattern.size(), _pattern) != 0) {
+            return false;  // 路径后缀不匹配
+        }
+        // 要求匹配在路径分隔处开始，避免 "Conn.cpp" 匹配到 "MyConn.cpp"
+        size_t pos = file.size() - _pattern.size();
+        return pos == 0 || file[pos - 1] == '/' || file[pos - 1] == '\\';
+    }
+
     void StdOutSink::LogtoSink(const char* data, size_t len){
         std::cout.write(data, len);  // 将日志消息输出到标准输出
         std::cout.flush();  // 刷新输出流，确保日志立即显示
@@ -65,4 +88,159 @@ namespace log{
         return filename;  // 返回生成的文件名
     }
 
-}
\ No newline at end of file
+    // 控制块中的状态和代数/大小字，代数占高24位，大小占低40位
+    struct SharedFileSink::Control{
+        static constexpr uint64_t kSizeBits = 40;
+        static constexpr uint64_t kSizeMask = (uint64_t(1) << kSizeBits) - 1;
+        static constexpr uint32_t kReady = 2;
+
+        static uint64_t Pack(uint64_t generation, uint64_t size) { return (generation << kSizeBits) | (size & kSizeMask); }
+        static uint64_t Generation(uint64_t word) { return word >> kSizeBits; }
+        static uint64_t Size(uint64_t word) { return word & kSizeMask; }
+
+        std::atomic<uint32_t> state; // 控制文件只在初始化完成后才出现，始终为 kReady
+        std::atomic<uint64_t> word; // 代数和当前文件大小
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "SharedFileSink needs lock-free atomics in shared memory");
+
+    namespace {
+        // 映射控制文件，失败时返回 nullptr
+        void* MapControl(int fd, size_t size){
+            void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            return addr == MAP_FAILED ? nullptr : addr;
+        }
+    }
+
+    SharedFileSink::SharedFileSink(const std::string& basename, size_t max_size) : _basename(basename), _max_size(max_size) {
+        if (!File::IsFileExist(File::GetPath(_basename))) {
+            File::CreateDir(File::GetPath(_basename));  // 如果目录不存在，创建目录
+        }
+        // 控制文件先在临时文件中初始化完整，再用 link 原子地放到最终位置（已存在时失败），
+        // 因此其他进程打开控制文件时它一定已经初始化完毕；初始化中途退出的进程只会留下临时文件，不会使其他进程等待
+        std::string ctl_name = _basename + ".ctl";
+        while (!_control) {
+            int ctl_fd = ::open(ctl_name.c_str(), O_RDWR | O_CLOEXEC);
+            if (ctl_fd >= 0) {
+                void* addr = MapControl(ctl_fd, sizeof(Control));
+                ::close(ctl_fd);  // 映射建立后不再需要文件描述符
+                if (!addr) {
+                    throw std::runtime_error("Failed to map log control file: " + ctl_name);
+                }
+                _control = static_cast<Control*>(addr);
+                break;
+            }
+            if (errno != ENOENT) {
+                throw std::runtime_error("Failed to open log control file: " + ctl_name + ": " + std::strerror(errno));
+            }
+
+            // 控制文件不存在：初始化临时文件，从代数0开始，大小取已有文件的大小
+            std::string tmp_name = ctl_name + "." + std::to_string(::getpid()) + "." + std::to_string(reinterpret_cast<uintptr_t>(this)) + ".tmp";  // 同一进程内的多个接收器也不冲突
+            int tmp_fd = ::open(tmp_name.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (tmp_fd < 0) {
+                throw std::runtime_error("Failed to create log control file: " + tmp_name);
+            }
+            void* addr = ::ftruncate(tmp_fd, sizeof(Control)) == 0 ? MapControl(tmp_fd, sizeof(Control)) : nullptr;
+            ::close(tmp_fd);
+            if (!addr) {
+                ::unlink(tmp_name.c_str());
+                throw std::runtime_error("Failed to initialize log control file: " + tmp_name);
+            }
+            Control* control = static_cast<Control*>(addr);
+            struct stat st{};
+            uint64_t size = ::stat(GetFileName(0).c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+            control->word.store(Control::Pack(0, size));
+            control->state.store(Control::kReady, std::memory_order_release);
+
+            int ret = ::link(tmp_name.c_str(), ctl_name.c_str());
+            int link_errno = errno;
+            ::unlink(tmp_name.c_str());
+            if (ret == 0) {
+                _control = control;  // 映射的就是最终的控制文件
+            } else {
+                ::munmap(addr, sizeof(Control));
+                if (link_errno != EEXIST) {
+                    throw std::runtime_error("Failed to create log control file: " + ctl_name + ": " + std::strerror(link_errno));
+                }
+                // 其他进程先完成了初始化，重新打开它的控制文件
+            }
+        }
+        try {
+            Reopen(Control::Generation(_control->word.load(std::memory_order_acquire)));
+        } catch (...) {
+            ::munmap(_control, sizeof(Control));
+            throw;
+        }
+    }
+
+    SharedFileSink::~SharedFileSink(){
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+        if (_control) {
+            ::munmap(_control, sizeof(Control));
+        }
+    }
+
+    void SharedFileSink::LogtoSink(const char* data, size_t len){
+        // 1. 通过CAS为本条日志预留空间，超过上限时由预留成功的这一次写入负责轮转
+        uint64_t word = _control->word.load(std::memory_order_acquire);
+        uint64_t next;
+        do {
+            uint64_t generation = Control::Generation(word);
+            uint64_t size = Control::Size(word);
+            if (size > 0 && size + len > _max_size) {
+                next = Control::Pack(generation + 1, len);  // 开始新的文件
+            } else {
+                next = Control::Pack(generation, size + len);
+            }
+        } while (!_control->word.compare_exchange_weak(word, next, std::memory_order_acq_rel, std::memory_order_acquire));
+
+        // 2. 本条日志属于更新的代数时重新打开（其他进程轮转后也会走到这里）；
+        //    同一进程内多个线程可能同时写入，写入时持有共享锁，切换文件时持有独占锁，不会关闭正在写入的文件
+        uint64_t generation = Control::Generation(next);
+        std::shared_lock<std::shared_mutex> lock(_fd_mutex);
+        if (generation > _generation) {
+            lock.unlock();
+            {
+                std::unique_lock<std::shared_mutex> reopen_lock(_fd_mutex);
+                if (generation > _generation) {
+                    Reopen(generation);
+                }
+            }
+            lock.lock();
+        }
+
+        // 3. 一次 O_APPEND 写入整条日志，保证多个进程的日志行不交错
+        while (len > 0) {
+            ssize_t n = ::write(_fd, data, len);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Failed to write log file: " + GetFileName(_generation) + ": " + std::strerror(errno));
+            }
+            data += n;
+            len -= static_cast<size_t>(n);
+        }
+    }
+
+    // 调用者需持有 _fd_mutex 的独占锁（构造时除外）
+    void SharedFileSink::Reopen(uint64_t generation){
+        std::string file_name = GetFileName(generation);
+        int fd = ::open(file_name.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open log file: " + file_name);  // 如果打开失败，抛出异常
+        }
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+        _fd = fd;
+        _generation = generation;
+    }
+
+    std::string SharedFileSink::GetFileName(uint64_t generation) const{
+        return _basename + "_" + std::to_string(generation) + ".log";  // 与RollBySizeSink相同的命名方式
+    }
+
+}
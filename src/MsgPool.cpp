@@ -0,0 +1,111 @@
+#include "../include/MsgPool.hpp"
+
+#include <mutex>
+#include <vector>
+
+namespace log{
+
+    namespace {
+        // 已退出线程留下的缓存，供新线程接管；对象在进程生命周期内不释放，在途缓冲区始终可以归还
+        struct OrphanList{
+            std::mutex mutex;
+            std::vector<MsgCache*> caches;
+        };
+
+        OrphanList& Orphans(){
+            static auto* orphans = new OrphanList();
+            return *orphans;
+        }
+
+        // 线程退出时把缓存交给孤儿列表
+        struct CacheHolder{
+            MsgCache* cache = nullptr;
+            ~CacheHolder(){
+                if (cache) {
+                    std::lock_guard<std::mutex> lock(Orphans().mutex);
+                    Orphans().caches.push_back(cache);
+                    cache = nullptr;
+                }
+            }
+        };
+
+        thread_local CacheHolder t_holder;
+
+        MsgCache* LocalCache(){
+            if (!t_holder.cache) {
+                {
+                    std::lock_guard<std::mutex> lock(Orphans().mutex);
+                    if (!Orphans().caches.empty()) {
+                        t_holder.cache = Orphans().caches.back();
+                        Orphans().caches.pop_back();
+                    }
+                }
+                if (!t_holder.cache) {
+                    t_holder.cache = new MsgCache();
+                }
+            }
+            return t_holder.cache;
+        }
+    }
+
+    void MsgBuffer::Releaser::operator()(MsgBuffer* buf) const{
+        MsgPool::Release(buf);
+    }
+
+    MsgBuffer* MsgCache::Acquire(){
+        if (!_free) {
+            _free = _returned.exchange(nullptr, std::memory_order_acquire);  // 一次取回其他线程归还的全部缓冲区
+        }
+        if (!_free) {
+            AllocateSlab();
+        }
+        MsgBuffer* buf = _free;
+        _free = buf->next;
+        buf->next = nullptr;
+        return buf;
+    }
+
+    void MsgCache::Push(MsgBuffer* buf){
+        MsgBuffer* head = _returned.load(std::memory_order_relaxed);
+        do {
+            buf->next = head;
+        } while (!_returned.compare_exchange_weak(head, buf, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void MsgCache::PushLocal(MsgBuffer* buf){
+        buf->next = _free;
+        _free = buf;
+    }
+
+    void MsgCache::AllocateSlab(){
+        auto* slab = new MsgBuffer[MsgPool::kSlabSize];  // 缓冲区不再归还系统
+        for (size_t i = 0; i < MsgPool::kSlabSize; i++) {
+            slab[i].owner = this;
+            slab[i].msg.clear();
+            slab[i].msg.getPayloadBuffer().reserve(MsgPool::kBufferSize);
+            PushLocal(&slab[i]);
+        }
+    }
+
+    MsgBuffer::ptr MsgPool::Acquire(){
+        return MsgBuffer::ptr(LocalCache()->Acquire());
+    }
+
+    void MsgPool::Release(MsgBuffer* buf){
+        if (!buf) {
+            return;
+        }
+        buf->msg.clear();
+        std::string& payload = buf->msg.getPayloadBuffer();
+        if (payload.capacity() > kMaxRetained) {
+            // 溢出路径：大消息用完后释放多余容量，使缓冲池保持固定大小
+            std::string().swap(payload);
+            payload.reserve(kBufferSize);
+        }
+        if (buf->owner == t_holder.cache) {
+            buf->owner->PushLocal(buf);  // 同步日志在本线程归还，无需原子操作
+        } else {
+            buf->owner->Push(buf);
+        }
+    }
+}
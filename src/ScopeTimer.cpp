@@ -0,0 +1,236 @@
+#include "../include/ScopeTimer.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <thread>
+
+namespace log{
+
+    // 所有调用位置的注册表和汇报线程
+    class TimerRegistry{
+        public:
+            static TimerRegistry& Instance(){
+                static TimerRegistry registry;
+                return registry;
+            }
+
+            ~TimerRegistry(){
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _stop = true;
+                }
+                _cond_var.notify_all();
+                if (_thread.joinable()) {
+                    _thread.join();
+                }
+            }
+
+            size_t Register(TimerSite* site){
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_thread.joinable()) {
+                    _thread = std::thread(&TimerRegistry::Run, this);
+                }
+                _sites.push_back(site);
+                return _next_id++;
+            }
+
+            void Unregister(TimerSite* site){
+                std::lock_guard<std::mutex> lock(_mutex);
+                _sites.erase(std::remove(_sites.begin(), _sites.end(), site), _sites.end());
+            }
+
+            void SetInterval(std::chrono::milliseconds interval){
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _interval = interval;
+                }
+                _cond_var.notify_all();
+            }
+
+            void ReportAll(){
+                std::lock_guard<std::mutex> lock(_report_mutex);  // 汇报期间调用位置不会被注销
+                std::vector<TimerSite*> sites;
+                {
+                    std::lock_guard<std::mutex> site_lock(_mutex);
+                    sites = _sites;
+                }
+                for (TimerSite* site : sites) {
+                    site->Report();
+                }
+            }
+
+            std::mutex& ReportMutex() { return _report_mutex; }
+
+        private:
+            TimerRegistry() = default;
+
+            void Run(){
+                std::unique_lock<std::mutex> lock(_mutex);
+                while (!_stop) {
+                    auto deadline = std::chrono::steady_clock::now() + _interval;
+                    if (_cond_var.wait_until(lock, deadline, [this]{ return _stop; })) {
+                        break;
+                    }
+                    if (std::chrono::steady_clock::now() < deadline) {
+                        continue;  // 汇报周期被修改，按新的周期重新等待
+                    }
+                    lock.unlock();
+                    ReportAll();
+                    lock.lock();
+                }
+            }
+
+            std::mutex _mutex;  // 保护 _sites、_interval 和 _stop
+            std::mutex _report_mutex;  // 汇报与注销互斥
+            std::condition_variable _cond_var;
+            std::thread _thread;
+            std::vector<TimerSite*> _sites;
+            size_t _next_id = 0;
+            std::chrono::milliseconds _interval{60000};
+            bool _stop = false;
+    };
+
+    TimerSite::TimerSite(const char* name, const char* file, size_t line, std::chrono::nanoseconds slow)
+        : _name(name), _file(file), _line(line), _slow_ns(slow.count() > 0 ? static_cast<uint64_t>(slow.count()) : 0) {
+        _id = TimerRegistry::Instance().Register(this);
+    }
+
+    TimerSite::~TimerSite(){
+        TimerRegistry& registry = TimerRegistry::Instance();
+        std::lock_guard<std::mutex> lock(registry.ReportMutex());
+        registry.Unregister(this);
+    }
+
+    TimerSite::ThreadLocals::~ThreadLocals(){
+        for (const auto& site : histograms) {
+            for (TimerHistogram* histogram : site) {
+                histogram->_owned.store(false, std::memory_order_release);  // 计数保留，由新线程接管
+            }
+        }
+    }
+
+    TimerHistogram& TimerSite::attach(std::weak_ptr<Logger> logger){
+        std::vector<std::vector<TimerHistogram*>>& locals = t_locals.histograms;
+        if (locals.size() <= _id) {
+            locals.resize(_id + 1);
+        }
+        std::vector<TimerHistogram*>& site_locals = locals[_id];
+
+        TimerHistogram* histogram = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            // 交还日志器已销毁的直方图
+            site_locals.erase(std::remove_if(site_locals.begin(), site_locals.end(), [](TimerHistogram* expired) {
+                if (!expired->_logger.expired()) {
+                    return false;
+                }
+                expired->_owned.store(false, std::memory_order_release);
+                return true;
+            }), site_locals.end());
+
+            // 接管已退出线程留下的同一日志器的直方图，或日志器已销毁的直方图
+            for (auto& orphan : _histograms) {
+                if (!orphan->BelongsTo(logger) && !orphan->_logger.expired()) {
+                    continue;
+                }
+                bool owned = false;
+                if (orphan->_owned.compare_exchange_strong(owned, true, std::memory_order_acquire)) {
+                    histogram = orphan.get();
+                    break;
+                }
+            }
+            if (!histogram) {
+                _histograms.push_back(std::make_unique<TimerHistogram>());
+                histogram = _histograms.back().get();
+            }
+            if (!histogram->BelongsTo(logger)) {
+                histogram->Clear();  // 已销毁日志器的计数不能记到新的日志器上
+                histogram->_logger = std::move(logger);
+            }
+        }
+        site_locals.push_back(histogram);
+        return *histogram;
+    }
+
+    void TimerSite::Report(){
+        // 同一日志器的直方图合并为一组
+        struct Group{
+            Logger::ptr logger;
+            std::array<uint64_t, TimerHistogram::kBuckets> counts{};
+            uint64_t total = 0;
+            uint64_t max = 0;
+        };
+        std::vector<Group> groups;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto& histogram : _histograms) {
+                Logger::ptr logger = histogram->_logger.lock();
+                if (!logger) {
+                    histogram->Clear();  // 日志器已销毁，丢弃计数
+                    continue;
+                }
+                auto group = std::find_if(groups.begin(), groups.end(), [&](const Group& g) { return g.logger == logger; });
+                if (group == groups.end()) {
+                    groups.emplace_back();
+                    group = groups.end() - 1;
+                    group->logger = std::move(logger);
+                }
+                for (size_t i = 0; i < TimerHistogram::kBuckets; i++) {
+                    uint64_t n = histogram->_buckets[i].exchange(0, std::memory_order_relaxed);
+                    group->counts[i] += n;
+                    group->total += n;
+                }
+                group->max = std::max(group->max, histogram->_max.exchange(0, std::memory_order_relaxed));
+            }
+        }
+
+        for (const Group& group : groups) {
+            if (group.total == 0) {
+                continue;
+            }
+            // 按排名找到百分位所在的桶，取桶内最大值
+            auto percentile = [&](double p) {
+                double exact = p * static_cast<double>(group.total);
+                uint64_t rank = static_cast<uint64_t>(exact);
+                if (static_cast<double>(rank) < exact || rank == 0) {
+                    rank++;  // 向上取整
+                }
+                uint64_t seen = 0;
+                for (size_t i = 0; i < TimerHistogram::kBuckets; i++) {
+                    seen += group.counts[i];
+                    if (seen >= rank) {
+                        return std::min(TimerHistogram::UpperBound(i), group.max);
+                    }
+                }
+                return group.max;
+            };
+            group.logger->Info(_file, _line, "timer ", _name, " count=", group.total,
+                               " p50=", ScopeTimer::FormatDuration(percentile(0.50)),
+                               " p99=", ScopeTimer::FormatDuration(percentile(0.99)),
+                               " max=", ScopeTimer::FormatDuration(group.max));
+        }
+    }
+
+    void TimerReporter::SetInterval(std::chrono::milliseconds interval){
+        TimerRegistry::Instance().SetInterval(interval);
+    }
+
+    void TimerReporter::ReportNow(){
+        TimerRegistry::Instance().ReportAll();
+    }
+
+    std::string ScopeTimer::FormatDuration(uint64_t ns){
+        char buffer[32];
+        if (ns < 1000) {
+            snprintf(buffer, sizeof(buffer), "%lluns", static_cast<unsigned long long>(ns));
+        } else if (ns < 1000000) {
+            snprintf(buffer, sizeof(buffer), "%.1fus", static_cast<double>(ns) / 1e3);
+        } else if (ns < 1000000000) {
+            snprintf(buffer, sizeof(buffer), "%.2fms", static_cast<double>(ns) / 1e6);
+        } else {
+            snprintf(buffer, sizeof(buffer), "%.2fs", static_cast<double>(ns) / 1e9);
+        }
+        return buffer;
+    }
+}
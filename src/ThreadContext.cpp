@@ -0,0 +1,108 @@
+#include "../include/ThreadContext.hpp"
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <utility>
+
+namespace log{
+
+    namespace {
+        thread_local ThreadInfo::ptr t_thread_info;  // 当前线程的线程信息缓存
+        thread_local MDC::ptr t_mdc;  // 当前线程的MDC快照
+
+        // 获取当前线程的系统线程名
+        std::string CurrentThreadName(){
+            char name[16] = {0};  // Linux线程名最长15个字符
+            if (pthread_getname_np(pthread_self(), name, sizeof(name)) != 0) {
+                return "";
+            }
+            return name;
+        }
+    }
+
+    ThreadInfo::ThreadInfo(pid_t tid, std::string name)
+        : _tid(tid), _tid_text(std::to_string(tid)), _name(std::move(name)) {}
+
+    const ThreadInfo::ptr& ThreadInfo::Current(){
+        if (!t_thread_info) {
+            // 只在线程第一次使用时执行系统调用
+            auto tid = static_cast<pid_t>(::syscall(SYS_gettid));
+            t_thread_info = std::make_shared<const ThreadInfo>(tid, CurrentThreadName());
+        }
+        return t_thread_info;
+    }
+
+    void ThreadInfo::SetName(const std::string& name){
+        pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());  // 系统线程名有长度限制，缓存中保留完整名称
+        // 生成新的只读对象，已经产生的日志消息仍然持有旧名称
+        t_thread_info = std::make_shared<const ThreadInfo>(Current()->getTid(), name);
+    }
+
+    MDC::Snapshot::Snapshot(Map values) : _values(std::move(values)) {
+        for (auto& [key, value] : _values) {
+            if (!_text.empty()) {
+                _text.append(1, ' ');
+            }
+            _text.append(key).append(1, '=').append(value);
+        }
+    }
+
+    const std::string* MDC::Snapshot::Find(std::string_view key) const{
+        auto it = _values.find(key);
+        return it == _values.end() ? nullptr : &it->second;
+    }
+
+    void MDC::Update(Map values){
+        if (values.empty()) {
+            t_mdc.reset();
+            return;
+        }
+        t_mdc = std::make_shared<const Snapshot>(std::move(values));
+    }
+
+    void MDC::Put(const std::string& key, const std::string& value){
+        Map values = t_mdc ? t_mdc->getValues() : Map{};
+        values[key] = value;
+        Update(std::move(values));
+    }
+
+    void MDC::Remove(const std::string& key){
+        if (!t_mdc || !t_mdc->Find(key)) {
+            return;
+        }
+        Map values = t_mdc->getValues();
+        values.erase(key);
+        Update(std::move(values));
+    }
+
+    void MDC::Clear(){
+        t_mdc.reset();
+    }
+
+    std::string MDC::Get(const std::string& key){
+        const std::string* value = t_mdc ? t_mdc->Find(key) : nullptr;
+        return value ? *value : "";
+    }
+
+    const MDC::ptr& MDC::Current(){
+        return t_mdc;
+    }
+
+    MDCGuard::MDCGuard(const std::string& key, const std::string& value) : _key(key), _had_old(false) {
+        const std::string* old_value = MDC::Current() ? MDC::Current()->Find(key) : nullptr;
+        if (old_value) {
+            _old_value = *old_value;
+            _had_old = true;
+        }
+        MDC::Put(key, value);
+    }
+
+    MDCGuard::~MDCGuard(){
+        if (_had_old) {
+            MDC::Put(_key, _old_value);
+        } else {
+            MDC::Remove(_key);
+        }
+    }
+}
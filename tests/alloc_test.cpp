@@ -0,0 +1,97 @@
+#include "AsyncLogger.hpp"
+#include "Logger.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+/*
+ * 检查日志路径在预热后不再分配内存：替换全局 operator new 统计所有线程的分配次数，
+ * 同步和异步日志器各自预热到稳定状态后，再记录若干批日志，分配次数应为0。
+ * 缓冲池按峰值积压增长且不收缩，异步预热时让后台线程阻塞在接收器中并写入两批日志，
+ * 使积压超过一整批，之后每批的积压都不会超过预热时的峰值。
+ */
+
+namespace {
+    std::atomic<size_t> g_allocations{0};
+
+    // 丢弃输出的接收器，hold 为true时阻塞写入，用于制造积压
+    class GateSink : public log::LogSink{
+        public:
+            void LogtoSink(const char* data, size_t len) override {
+                (void)data;
+                while (hold.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                _bytes.fetch_add(len, std::memory_order_relaxed);
+            }
+
+            std::atomic<bool> hold{false};
+
+        private:
+            std::atomic<size_t> _bytes{0};
+    };
+
+    constexpr int kRecords = 2000;  // 每批日志条数
+    constexpr int kRounds = 5;  // 检查的批数
+
+    template<class LoggerPtr>
+    void LogRecords(const LoggerPtr& logger){
+        for (int i = 0; i < kRecords; i++) {
+            logger->Info(__FILE__, __LINE__, "record ", i, " value=", 3.5 * i);
+        }
+    }
+
+    template<class LoggerPtr, class Drain>
+    bool Check(const char* name, const LoggerPtr& logger, Drain drain){
+        size_t before = g_allocations.load();
+        for (int round = 0; round < kRounds; round++) {
+            LogRecords(logger);
+            drain();
+        }
+        size_t allocations = g_allocations.load() - before;
+        std::printf("%s: %zu allocations for %d records\n", name, allocations, kRecords * kRounds);
+        return allocations == 0;
+    }
+}
+
+void* operator new(size_t size){
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept{
+    std::free(p);
+}
+
+int main(){
+    auto sink = std::make_shared<GateSink>();
+    std::vector<log::LogSink::ptr> sinks{sink};
+    auto formatter = std::make_shared<log::Formatter>("%d{%H:%M:%S}[%p][%c][%t][%f:%l]%T%m%n");
+
+    auto sync_logger = std::make_shared<log::Logger>("sync", log::LogLevel::Level::DEBUG, formatter, sinks);
+    LogRecords(sync_logger);  // 预热
+    bool ok = Check("sync", sync_logger, []{});
+
+    auto async_logger = std::make_shared<log::AsyncLogger>("async", log::LogLevel::Level::DEBUG, formatter, sinks);
+    for (int round = 0; round < 3; round++) {
+        // 预热：后台线程阻塞时写入两批，缓冲池和各处字符串增长到最大积压所需的大小
+        sink->hold = true;
+        LogRecords(async_logger);
+        LogRecords(async_logger);
+        sink->hold = false;
+        async_logger->Flush();
+    }
+    ok = Check("async", async_logger, [&]{ async_logger->Flush(); }) && ok;
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,8 @@
+#include "Logger.hpp"
+
+// 无占位符却以整数作为第一个参数的调用有歧义，应在编译期报错（format_ambiguous_call 测试期望编译失败）
+int main(){
+    auto logger = std::make_shared<log::Logger>("fmt");
+    logger->Info("retrying", 3);
+    return 0;
+}
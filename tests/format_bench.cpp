@@ -0,0 +1,65 @@
+#include "AsyncLogger.hpp"
+#include "Logger.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * 对比 format_threads 为1和N时单个异步日志器的吞吐：生产者线程写入固定条数的日志，
+ * 计时到 Flush 返回为止。接收器只统计字节数，测量的是格式化和重排本身的开销。
+ * 用法：format_bench [条数] [N]，N 默认为 CPU 核数。
+ */
+
+namespace {
+    // 丢弃输出的接收器
+    class CountSink : public log::LogSink{
+        public:
+            void LogtoSink(const char* data, size_t len) override {
+                (void)data;
+                _bytes.fetch_add(len, std::memory_order_relaxed);
+            }
+
+            size_t GetBytes() const { return _bytes.load(std::memory_order_relaxed); }
+
+        private:
+            std::atomic<size_t> _bytes{0};
+    };
+
+    double Run(size_t format_threads, size_t records){
+        auto sink = std::make_shared<CountSink>();
+        auto formatter = std::make_shared<log::Formatter>("%d{%Y-%m-%d %H:%M:%S}[%p][%c][%t][%f:%l]%T%m%n");
+        log::AsyncOptions options;
+        options.format_threads = format_threads;
+        options.batch_size = 64;
+        auto logger = std::make_shared<log::AsyncLogger>("bench", log::LogLevel::Level::DEBUG, formatter,
+                                                         std::vector<log::LogSink::ptr>{sink}, options);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < records; i++) {
+            logger->Info(__FILE__, __LINE__, "request ", i, " took ", 0.25 * static_cast<double>(i), " ms");
+        }
+        logger->Flush();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(records) / elapsed.count();
+    }
+}
+
+int main(int argc, char* argv[]){
+    size_t records = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    size_t threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+    if (threads < 2) {
+        threads = 2;
+    }
+
+    Run(1, records / 10);  // 预热缓冲池
+    double single = Run(1, records);
+    double multi = Run(threads, records);
+    std::printf("format_threads=1: %.0f records/s\n", single);
+    std::printf("format_threads=%zu: %.0f records/s (%.2fx)\n", threads, multi, multi / single);
+    return EXIT_SUCCESS;
+}
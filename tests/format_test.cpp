@@ -0,0 +1,71 @@
+#include "Logger.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+/*
+ * 检查 std::format 风格的调用（std::format 或 LOG_USE_FMT 下的 {fmt}）：
+ * 占位符按参数格式化，调用位置自动捕获，Info(__FILE__, __LINE__, ...) 仍按旧方式输出。
+ * 格式化后端不可用时跳过（返回77）。
+ */
+
+#if LOG_HAS_FORMAT
+
+namespace {
+    class StringSink : public log::LogSink{
+        public:
+            void LogtoSink(const char* data, size_t len) override {
+                lines.append(data, len);
+            }
+            std::string lines;
+    };
+
+    bool Expect(const std::string& actual, const std::string& expected){
+        if (actual != expected) {
+            std::printf("expected: %s\nactual:   %s\n", expected.c_str(), actual.c_str());
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(){
+    auto sink = std::make_shared<StringSink>();
+    auto logger = std::make_shared<log::Logger>("fmt", log::LogLevel::Level::DEBUG,
+                                                std::make_shared<log::Formatter>("[%p][%l]%m%n"), std::vector<log::LogSink::ptr>{sink});
+    bool ok = true;
+
+    size_t line = __LINE__ + 1;
+    logger->Info("conn {} took {:.3f} ms", 7, 1.5);
+    ok = Expect(sink->lines, "[INFO][" + std::to_string(line) + "]conn 7 took 1.500 ms\n") && ok;
+
+    sink->lines.clear();
+    logger->Warn("retrying {} of {}", 3, 5);
+    ok = Expect(sink->lines.substr(sink->lines.find(']', 7) + 1), "retrying 3 of 5\n") && ok;
+
+    sink->lines.clear();
+    logger->Error(__FILE__, 42, "legacy ", 1, " call");  // 旧调用方式：文件名、行号和流式参数
+    ok = Expect(sink->lines, "[ERROR][42]legacy 1 call\n") && ok;
+
+    sink->lines.clear();
+    logger->Warn(std::string_view("main.cpp"), 7, "explicit file");  // 其他文件名需以非字符串常量传入
+    ok = Expect(sink->lines, "[WARN][7]explicit file\n") && ok;
+
+    sink->lines.clear();
+    logger->Debug("no arguments");
+    ok = Expect(sink->lines.substr(sink->lines.find(']', 8) + 1), "no arguments\n") && ok;
+
+    std::printf("%s\n", ok ? "format test passed" : "format test failed");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#else
+
+int main(){
+    std::printf("no format backend, skipped\n");
+    return 77;
+}
+
+#endif
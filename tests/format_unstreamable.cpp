@@ -0,0 +1,12 @@
+#include "Logger.hpp"
+
+// 旧调用方式中不能通过 operator<< 输出的参数应在编译期报错，而不是丢弃整条日志（format_unstreamable_call 测试期望编译失败）
+namespace {
+    struct Opaque{};
+}
+
+int main(){
+    auto logger = std::make_shared<log::Logger>("fmt");
+    logger->Info(__FILE__, __LINE__, "value ", Opaque{});
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "AsyncLogger.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+/*
+ * 检查并行格式化（format_threads > 1）时输出顺序与入队顺序完全一致：
+ * 用很小的 batch_size 让多个工作线程交替取出批次，按序号写入的日志在接收器中应严格递增、不重不漏。
+ */
+
+namespace {
+    // 解析每行的序号并检查是否连续
+    class OrderSink : public log::LogSink{
+        public:
+            void LogtoSink(const char* data, size_t len) override {
+                _pending.append(data, len);
+                size_t begin = 0;
+                size_t end;
+                while ((end = _pending.find('\n', begin)) != std::string::npos) {
+                    unsigned long value = std::strtoul(_pending.c_str() + begin, nullptr, 10);
+                    if (value != next && errors++ < 10) {
+                        std::printf("expected record %lu, got %lu\n", next, value);
+                    }
+                    next = value + 1;
+                    begin = end + 1;
+                }
+                _pending.erase(0, begin);
+            }
+
+            unsigned long next = 0;  // 下一条期望的序号
+            size_t errors = 0;
+
+        private:
+            std::string _pending;  // 不完整的一行
+    };
+
+    constexpr unsigned long kRecords = 200000;
+}
+
+int main(){
+    auto sink = std::make_shared<OrderSink>();
+    log::AsyncOptions options;
+    options.format_threads = 4;
+    options.batch_size = 4;
+    auto logger = std::make_shared<log::AsyncLogger>("order", log::LogLevel::Level::DEBUG, std::make_shared<log::Formatter>("%m%n"),
+                                                     std::vector<log::LogSink::ptr>{sink}, options);
+    for (unsigned long i = 0; i < kRecords; i++) {
+        logger->Info(__FILE__, __LINE__, i);
+    }
+    logger->Flush();
+
+    bool ok = sink->errors == 0 && sink->next == kRecords;
+    std::printf("%lu records, %zu out of order: %s\n", sink->next, sink->errors, ok ? "passed" : "failed");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
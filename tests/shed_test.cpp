@@ -0,0 +1,137 @@
+#include "AsyncLogger.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * 检查按水位逐级丢弃：后台线程阻塞在接收器中时写入各级别的日志制造积压，放行后检查
+ * ERROR/FATAL 从不丢弃，每个级别丢弃数与输出数之和等于写入数，且只输出一条汇总；
+ * 积压期间把接收器级别提高到 ERROR（有效阈值高于 WARN）时不输出汇总。
+ */
+
+namespace {
+    using Level = log::LogLevel::Level;
+    constexpr std::array<Level, 5> kLevels{Level::DEBUG, Level::INFO, Level::WARN, Level::ERROR, Level::FATAL};
+    constexpr size_t kRounds = 300;  // 每个级别写入的条数
+    const std::string kSummary = "log backlog shed";
+
+    // hold 为true时阻塞写入，按级别统计输出的日志，单独记录汇总行
+    class GateSink : public log::LogSink{
+        public:
+            void LogtoSink(const char* data, size_t len) override {
+                entered = true;
+                while (hold.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                std::lock_guard<std::mutex> lock(_mutex);
+                std::string text(data, len);  // 后台线程可能把多条日志合并成一次写入
+                size_t begin = 0;
+                size_t end;
+                while ((end = text.find('\n', begin)) != std::string::npos) {
+                    Count(text.substr(begin, end - begin));
+                    begin = end + 1;
+                }
+            }
+
+            std::atomic<bool> hold{true};
+            std::atomic<bool> entered{false};
+            std::array<size_t, kLevels.size()> emitted{};
+            std::vector<std::string> summaries;
+
+        private:
+            void Count(const std::string& line) {
+                if (line.find(kSummary) != std::string::npos) {
+                    summaries.push_back(line);
+                    return;
+                }
+                for (size_t i = 0; i < kLevels.size(); i++) {
+                    if (line.compare(0, line.find(']') + 1, "[" + log::LogLevel::ToString(kLevels[i]) + "]") == 0) {
+                        emitted[i]++;
+                    }
+                }
+            }
+
+            std::mutex _mutex;
+    };
+
+    // 汇总行中某个级别的丢弃数量
+    size_t ShedCount(const std::string& summary, Level level){
+        std::string key = " " + std::string(log::LogLevel::ToString(level)) + "=";
+        size_t pos = summary.find(key);
+        return pos == std::string::npos ? 0 : std::strtoul(summary.c_str() + pos + key.size(), nullptr, 10);
+    }
+
+    bool Run(bool raise_level){
+        auto sink = std::make_shared<GateSink>();
+        log::AsyncOptions options;
+        options.shed_debug_watermark = 50;
+        options.shed_info_watermark = 100;
+        options.shed_warn_watermark = 150;
+        auto logger = std::make_shared<log::AsyncLogger>("shed", Level::DEBUG, std::make_shared<log::Formatter>("[%p]%m%n"),
+                                                         std::vector<log::LogSink::ptr>{sink}, options);
+
+        std::array<size_t, kLevels.size()> submitted{};
+        logger->Info(__FILE__, __LINE__, "first");  // 后台线程阻塞在这一条上
+        submitted[1]++;
+        while (!sink->entered) {
+            std::this_thread::yield();
+        }
+        for (size_t round = 0; round < kRounds; round++) {
+            logger->Debug(__FILE__, __LINE__, "debug ", round);
+            logger->Info(__FILE__, __LINE__, "info ", round);
+            logger->Warn(__FILE__, __LINE__, "warn ", round);
+            logger->Error(__FILE__, __LINE__, "error ", round);
+            logger->Fatal(__FILE__, __LINE__, "fatal ", round);
+            for (size_t& count : submitted) {
+                count++;
+            }
+        }
+        if (raise_level) {
+            sink->SetLevel(Level::ERROR);
+        }
+        sink->hold = false;
+        logger->Flush();
+
+        bool ok = true;
+        if (raise_level) {
+            if (!sink->summaries.empty()) {
+                std::printf("level above WARN: summary should be suppressed, got %s", sink->summaries[0].c_str());
+                ok = false;
+            }
+        } else if (sink->summaries.size() != 1) {
+            std::printf("expected exactly one summary, got %zu\n", sink->summaries.size());
+            ok = false;
+        }
+        for (size_t i = 0; i < kLevels.size(); i++) {
+            Level level = kLevels[i];
+            size_t shed = sink->summaries.empty() ? 0 : ShedCount(sink->summaries[0], level);
+            if (level >= Level::ERROR && (shed != 0 || sink->emitted[i] != submitted[i])) {
+                std::printf("%s must never be shed: submitted=%zu emitted=%zu shed=%zu\n",
+                            log::LogLevel::ToString(level).c_str(), submitted[i], sink->emitted[i], shed);
+                ok = false;
+            }
+            if (!raise_level && shed + sink->emitted[i] != submitted[i]) {
+                std::printf("%s: submitted=%zu emitted=%zu shed=%zu\n", log::LogLevel::ToString(level).c_str(), submitted[i], sink->emitted[i], shed);
+                ok = false;
+            }
+        }
+        if (!raise_level && !sink->summaries.empty() && ShedCount(sink->summaries[0], Level::DEBUG) == 0) {
+            std::printf("backlog did not reach the DEBUG watermark\n");
+            ok = false;
+        }
+        return ok;
+    }
+}
+
+int main(){
+    bool ok = Run(false);
+    ok = Run(true) && ok;
+    std::printf("shed test %s\n", ok ? "passed" : "failed");
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}